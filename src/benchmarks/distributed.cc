@@ -0,0 +1,65 @@
+// SUMMA product and distributed LU on ranks forked over Unix sockets:
+// strong scaling keeps n fixed as the ranks grow, weak scaling keeps the
+// elements per rank fixed (n grows with the square root of the ranks);
+// every rank, the parent one included, runs on a single thread so that
+// the ranks alone account for the scaling
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "s21_matrix/s21_distributed.h"
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+const int kBlock = 64;
+
+double element(int i, int j) {
+  return (i * 7 + j * 13) % 17 - 8.0 + (i == j ? 32.0 : 0.0);
+}
+
+// milliseconds of body between two barriers, as seen by rank 0
+double measure(const S21ProcessGrid& grid, const std::function<void()>& body) {
+  grid.Barrier();
+  auto start = std::chrono::steady_clock::now();
+  body();
+  grid.Barrier();
+  std::chrono::duration<double, std::milli> time =
+      std::chrono::steady_clock::now() - start;
+  return time.count();
+}
+
+void row(const char* kind, int ranks, int n) {
+  S21SocketTransport::Spawn(ranks, [&](S21Transport& transport) {
+    S21ProcessGrid grid(transport);
+    S21DistributedMatrix a =
+        S21DistributedMatrix::FromGenerator(grid, n, n, kBlock, element);
+    double mul = measure(grid, [&] {
+      S21DistributedMatrix c = a;
+      c.MulMatrix(a);
+    });
+    double lu = measure(grid, [&] { S21DistributedLU factors(a); });
+    if (transport.Rank() == 0) {
+      std::printf("%6s %6d %4dx%-4d %6d %10.1f %10.1f\n", kind, ranks,
+                  grid.GetRows(), grid.GetCols(), n, mul, lu);
+    }
+  });
+}
+}  // namespace
+
+int main() {
+  // forked ranks run their kernels inline, rank 0 would otherwise have the
+  // whole pool; the pool reads this on first use
+  setenv("S21_THREADS", "1", 1);
+  std::printf("block %d, threads per rank %d, milliseconds\n", kBlock,
+              S21ThreadPool::Instance().ThreadCount());
+  std::printf("%6s %6s %9s %6s %10s %10s\n", "kind", "ranks", "grid", "n",
+              "mul", "lu");
+  for (int ranks : {1, 2, 4}) row("strong", ranks, 1024);
+  for (int ranks : {1, 2, 4}) {
+    row("weak", ranks, static_cast<int>(512 * std::sqrt(ranks)));
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+// text ingestion and output in GB/s of file size: the mapped parallel
+// readers and the parallel writers against the iostream way of doing it;
+// run with S21_THREADS=1, 2, ... to get the scaling table, see make bench
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "s21_matrix/s21_matrix_oop.h"
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+// best of three runs, in seconds
+double measure(const std::function<void()>& body) {
+  double best = 0;
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    if (run == 0 || time.count() < best) best = time.count();
+  }
+  return best;
+}
+
+long fileSize(const char* path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  return static_cast<long>(file.tellg());
+}
+
+S21Matrix naiveCSV(const char* path, int rows, int cols) {
+  S21Matrix result(rows, cols);
+  std::ifstream file(path);
+  std::string line, field;
+  for (int i = 0; i < rows && std::getline(file, line); i++) {
+    std::istringstream fields(line);
+    for (int j = 0; j < cols && std::getline(fields, field, ','); j++) {
+      result(i, j) = std::stod(field);
+    }
+  }
+  return result;
+}
+
+void naiveWriteCSV(const S21Matrix& matrix, const char* path) {
+  std::ofstream file(path);
+  file << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for (int i = 0; i < matrix.GetRows(); i++) {
+    for (int j = 0; j < matrix.GetCols(); j++) {
+      if (j > 0) file << ',';
+      file << matrix(i, j);
+    }
+    file << '\n';
+  }
+}
+
+S21Matrix naiveMatrixMarket(const char* path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  bool coordinate = line.find("coordinate") != std::string::npos;
+  while (file.peek() == '%') std::getline(file, line);
+  int rows = 0, cols = 0;
+  long entries = 0;
+  file >> rows >> cols;
+  if (coordinate) file >> entries;
+  S21Matrix result(rows, cols);
+  if (coordinate) {
+    int i = 0, j = 0;
+    double value = 0;
+    for (long k = 0; k < entries && file >> i >> j >> value; k++) {
+      result(i - 1, j - 1) = value;
+    }
+  } else {
+    for (int j = 0; j < cols; j++) {
+      for (int i = 0; i < rows; i++) file >> result(i, j);
+    }
+  }
+  return result;
+}
+}  // namespace
+
+int main() {
+  const int rows = 2000, cols = 1000;
+  S21Matrix a = S21Matrix::Random(rows, cols, 1);
+  // half the elements zero so that the coordinate file is not all entries
+  for (int i = 0; i < rows; i++) {
+    for (int j = i % 2; j < cols; j += 2) a(i, j) = 0;
+  }
+  std::printf("threads %d, %d x %d, GB/s of file\n",
+              S21ThreadPool::Instance().ThreadCount(), rows, cols);
+  std::printf("%12s %8s %10s %10s %10s %10s\n", "format", "MB", "read",
+              "write", "ios_read", "ios_write");
+  struct Case {
+    const char* name;
+    const char* path;
+    std::function<void()> write, read, naive_write, naive_read;
+  };
+  const char* csv = "bench_io.csv";
+  const char* mtx = "bench_io.mtx";
+  Case cases[] = {
+      {"csv", csv, [&] { a.ToCSV(csv); }, [&] { S21Matrix::FromCSV(csv); },
+       [&] { naiveWriteCSV(a, csv); }, [&] { naiveCSV(csv, rows, cols); }},
+      {"mtx_array", mtx, [&] { a.ToMatrixMarket(mtx); },
+       [&] { S21Matrix::FromMatrixMarket(mtx); }, nullptr,
+       [&] { naiveMatrixMarket(mtx); }},
+      {"mtx_coord", mtx,
+       [&] { a.ToMatrixMarket(mtx, S21MatrixMarketFormat::kCoordinate); },
+       [&] { S21Matrix::FromMatrixMarket(mtx); }, nullptr,
+       [&] { naiveMatrixMarket(mtx); }},
+  };
+  for (auto& test : cases) {
+    double write = measure(test.write);
+    double gigabytes = fileSize(test.path) / 1e9;
+    double read = measure(test.read);
+    double naive_read = measure(test.naive_read);
+    std::printf("%12s %8.1f %10.3f %10.3f %10.3f", test.name,
+                gigabytes * 1e3, gigabytes / read, gigabytes / write,
+                gigabytes / naive_read);
+    if (test.naive_write) {
+      std::printf(" %10.3f\n", gigabytes / measure(test.naive_write));
+    } else {
+      std::printf(" %10s\n", "-");
+    }
+    std::remove(test.path);
+  }
+  return 0;
+}
@@ -0,0 +1,51 @@
+// randomized SVD of a rank 20 plus noise matrix with both sketches, and a
+// product with 16 vectors through the dense matrix and through the factors
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+#include "s21_matrix/s21_lowrank.h"
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+// best of three runs, in milliseconds
+double measure(const std::function<void()>& body) {
+  double best = 0;
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+    if (run == 0 || time.count() < best) best = time.count();
+  }
+  return best;
+}
+}  // namespace
+
+int main() {
+  const int rank = 20;
+  std::printf("threads %d, rank %d, milliseconds\n",
+              S21ThreadPool::Instance().ThreadCount(), rank);
+  std::printf("%6s %10s %10s %10s %12s %10s\n", "n", "svd_gauss", "svd_srht",
+              "dense_mul", "lowrank_mul", "rel_error");
+  for (int n : {500, 1000, 2000, 4000}) {
+    S21Matrix a =
+        S21Matrix::Random(n, rank, 1) * S21Matrix::Random(rank, n, 2) +
+        S21Matrix::Random(n, n, 3) * 1e-3;
+    S21Matrix x = S21Matrix::Random(n, 16, 4);
+    S21RandomizedOptions gaussian, srht;
+    srht.sketch = S21SketchKind::kSrht;
+    S21LowRankMatrix svd = S21LowRankMatrix::RandomizedSvd(a, rank, gaussian);
+    double svd_gauss =
+        measure([&] { S21LowRankMatrix::RandomizedSvd(a, rank, gaussian); });
+    double svd_srht =
+        measure([&] { S21LowRankMatrix::RandomizedSvd(a, rank, srht); });
+    double dense = measure([&] { a * x; });
+    double factored = measure([&] { svd.Multiply(x); });
+    double error = (a - svd.ToDense()).FrobeniusNorm() / a.FrobeniusNorm();
+    std::printf("%6d %10.1f %10.1f %10.2f %12.2f %10.2e\n", n, svd_gauss,
+                svd_srht, dense, factored, error);
+  }
+  return 0;
+}
@@ -0,0 +1,49 @@
+// tiled LU and Cholesky on the task graph against the fork-join versions;
+// run with S21_THREADS=1, 2, ... to get the scaling table, see make bench
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+#include "s21_matrix/s21_cholesky.h"
+#include "s21_matrix/s21_lu.h"
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+// best of three runs, in milliseconds
+double measure(const std::function<void()>& body) {
+  double best = 0;
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+    if (run == 0 || time.count() < best) best = time.count();
+  }
+  return best;
+}
+}  // namespace
+
+int main() {
+  const int tile = 128;
+  std::printf("threads %d, tile %d, milliseconds\n",
+              S21ThreadPool::Instance().ThreadCount(), tile);
+  std::printf("%6s %10s %10s %10s %10s %10s\n", "n", "lu", "lu_fj",
+              "lu_dag", "chol_fj", "chol_dag");
+  for (int n : {256, 512, 1024, 2048}) {
+    S21Matrix a = S21Matrix::Random(n, n, n);
+    S21Matrix spd = a * a.Transpose() + S21Matrix::Identity(n) * n;
+    double lu = measure([&] { S21LU factors(a); });
+    double lu_fj =
+        measure([&] { S21LU factors(a, tile, S21Schedule::kForkJoin); });
+    double lu_dag =
+        measure([&] { S21LU factors(a, tile, S21Schedule::kDataflow); });
+    double chol_fj =
+        measure([&] { S21Cholesky factor(spd, tile, S21Schedule::kForkJoin); });
+    double chol_dag =
+        measure([&] { S21Cholesky factor(spd, tile, S21Schedule::kDataflow); });
+    std::printf("%6d %10.1f %10.1f %10.1f %10.1f %10.1f\n", n, lu, lu_fj,
+                lu_dag, chol_fj, chol_dag);
+  }
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include "s21_matrix/s21_cholesky.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+S21Cholesky::S21Cholesky(const S21Matrix& matrix, int tile,
+                         S21Schedule schedule)
+    : factor_(matrix.ToLayout(S21Layout::kRowMajor)) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  if (tile < 1) throw std::invalid_argument("Tile size must be positive");
+  const long n = factor_.GetRows();
+  const int tiles = static_cast<int>((n + tile - 1) / tile);
+  double* a = factor_.data();
+  auto key = [tiles](int i, int j) { return static_cast<long>(i) * tiles + j; };
+  // one past the last row or column of tile t
+  auto end = [&](int t) {
+    return static_cast<int>(std::min<long>(n, static_cast<long>(t + 1) * tile));
+  };
+
+  S21TileGraph graph(schedule);
+  for (auto k = 0; k < tiles; k++) {
+    const int c0 = k * tile, c1 = end(k);
+    // L(k, k), unblocked
+    graph.AddTask(
+        [=] {
+          for (auto c = c0; c < c1; c++) {
+            double* row = a + c * n;
+            double diagonal = row[c];
+            for (auto q = c0; q < c; q++) diagonal -= row[q] * row[q];
+            if (!(diagonal > 0.0)) {
+              throw std::logic_error("The matrix is not positive definite.");
+            }
+            row[c] = std::sqrt(diagonal);
+            for (auto i = c + 1; i < c1; i++) {
+              double* below = a + i * n;
+              double sum = below[c];
+              for (auto q = c0; q < c; q++) sum -= below[q] * row[q];
+              below[c] = sum / row[c];
+            }
+          }
+        },
+        {}, {key(k, k)}, 3 * (tiles - k) + 2);
+    graph.Barrier();
+
+    // L(i, k) = A(i, k) * L(k, k)^-T
+    for (auto i = k + 1; i < tiles; i++) {
+      const int i0 = i * tile, i1 = end(i);
+      graph.AddTask(
+          [=] {
+            for (auto r = i0; r < i1; r++) {
+              double* row = a + r * n;
+              for (auto c = c0; c < c1; c++) {
+                const double* diagonal = a + c * n;
+                double sum = row[c];
+                for (auto q = c0; q < c; q++) sum -= row[q] * diagonal[q];
+                row[c] = sum / diagonal[c];
+              }
+            }
+          },
+          {key(k, k)}, {key(i, k)}, 3 * (tiles - i) + 1);
+    }
+    graph.Barrier();
+
+    // A(i, j) -= L(i, k) * L(j, k)^T on and below the diagonal
+    for (auto i = k + 1; i < tiles; i++) {
+      const int i0 = i * tile, i1 = end(i);
+      for (auto j = k + 1; j <= i; j++) {
+        const int j0 = j * tile, j1 = end(j);
+        graph.AddTask(
+            [=] {
+              for (auto r = i0; r < i1; r++) {
+                const double* l_r = a + r * n;
+                int last = i == j ? r + 1 : j1;
+                for (auto s = j0; s < last; s++) {
+                  const double* l_s = a + s * n;
+                  double sum = 0.0;
+                  for (auto q = c0; q < c1; q++) sum += l_r[q] * l_s[q];
+                  a[r * n + s] -= sum;
+                }
+              }
+            },
+            {key(i, k), key(j, k)}, {key(i, j)}, 3 * (tiles - j));
+      }
+    }
+    graph.Barrier();
+  }
+  graph.Run();
+  for (auto r = 0; r < n; r++) {
+    std::fill(a + r * n + r + 1, a + (r + 1) * n, 0.0);
+  }
+}
+
+int S21Cholesky::GetSize() const noexcept { return factor_.GetRows(); }
+
+const S21Matrix& S21Cholesky::GetFactor() const noexcept { return factor_; }
+
+double S21Cholesky::Determinant() const noexcept {
+  const int n = GetSize();
+  const double* l = factor_.data();
+  double result = 1.0;
+  for (auto i = 0; i < n; i++) result *= l[i * n + i] * l[i * n + i];
+  return result;
+}
+
+S21Matrix S21Cholesky::Solve(const S21Matrix& rhs) const {
+  const int n = GetSize();
+  if (rhs.GetRows() != n) {
+    throw std::logic_error(
+        "Incorrect input, the right-hand side must have as many rows as the "
+        "matrix.");
+  }
+  const int m = rhs.GetCols();
+  const double* l = factor_.data();
+  S21Matrix result = rhs.ToLayout(S21Layout::kRowMajor);
+  double* x = result.data();
+  // L * Y = rhs, then L^T * X = Y, both row by row
+  for (auto i = 0; i < n; i++) {
+    for (auto k = 0; k < i; k++) {
+      double factor = l[i * n + k];
+      for (auto j = 0; j < m; j++) x[i * m + j] -= factor * x[k * m + j];
+    }
+    for (auto j = 0; j < m; j++) x[i * m + j] /= l[i * n + i];
+  }
+  for (auto i = n - 1; i >= 0; i--) {
+    for (auto j = 0; j < m; j++) x[i * m + j] /= l[i * n + i];
+    for (auto k = 0; k < i; k++) {
+      double factor = l[i * n + k];
+      for (auto j = 0; j < m; j++) x[k * m + j] -= factor * x[i * m + j];
+    }
+  }
+  return result;
+}
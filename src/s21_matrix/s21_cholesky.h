@@ -0,0 +1,30 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_CHOLESKY_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_CHOLESKY_H_
+
+#include "s21_matrix/s21_matrix_oop.h"
+#include "s21_matrix/s21_tile_graph.h"
+
+// Cholesky factorization A = L * L^T of a symmetric positive definite
+// matrix, tiled on a task graph: the diagonal tile factorizations, the
+// triangular solves below them and the symmetric updates of the trailing
+// matrix are separate tasks; only the lower triangle of A is read
+class S21Cholesky {
+ public:
+  // throws std::logic_error for a non-square or not positive definite
+  // matrix and std::invalid_argument for a tile size below 1
+  explicit S21Cholesky(const S21Matrix& matrix, int tile = 128,
+                       S21Schedule schedule = S21Schedule::kDataflow);
+
+  int GetSize() const noexcept;
+  // L, row-major with zeros above the diagonal
+  const S21Matrix& GetFactor() const noexcept;
+
+  double Determinant() const noexcept;
+  // X with A * X = rhs
+  S21Matrix Solve(const S21Matrix& rhs) const;
+
+ private:
+  S21Matrix factor_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_CHOLESKY_H_
@@ -0,0 +1,635 @@
+#include "s21_matrix/s21_distributed.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// tags keep the messages of different steps apart
+enum Tag {
+  kTagBarrier = 1,
+  kTagScatter,
+  kTagGather,
+  kTagSummaA,
+  kTagSummaB,
+  kTagPivot,
+  kTagSwap,
+  kTagPivotRow,
+  kTagSwaps,
+  kTagPanel,
+  kTagBlockRow,
+  kTagDiagonal,
+  kTagSolve,
+  kTagDeterminant,
+};
+
+// grid row or column holding global row or column index
+int owner(int index, int block, int procs) { return index / block % procs; }
+
+// position of global index among the rows or columns of its owner
+int localIndex(int index, int block, int procs) {
+  return index / (block * procs) * block + index % block;
+}
+
+// how many of the global indices below end grid position me holds
+int localCount(int end, int block, int procs, int me) {
+  int blocks = end / block;
+  int count = blocks / procs * block;
+  int extra = blocks % procs;
+  if (me < extra) {
+    count += block;
+  } else if (me == extra) {
+    count += end % block;
+  }
+  return count;
+}
+
+// the largest divisor of size not above its square root
+int squarestRows(int size) {
+  int rows = static_cast<int>(std::sqrt(std::max(size, 1)));
+  while (rows > 1 && size % rows) rows--;
+  return std::max(rows, 1);
+}
+
+int globalIndex(int local, int block, int procs, int me) {
+  return (local / block * procs + me) * block + local % block;
+}
+
+// rows x cols starting at data with the given row stride, as a view
+S21MatrixView view(double* data, int rows, int cols, int stride) {
+  return S21Matrix::Wrap(data, rows, cols, S21Layout::kRowMajor, stride);
+}
+
+// interchanges global rows r and s of the local matrices within local
+// columns [begin, end), the grid rows holding them trade their parts
+void exchangeRows(const S21ProcessGrid& grid, S21Matrix& local, int block,
+                  int r, int s, int begin, int end) {
+  if (r == s || begin >= end) return;
+  const int procs = grid.GetRows();
+  const int me = grid.GetRow();
+  const int owner_r = owner(r, block, procs);
+  const int owner_s = owner(s, block, procs);
+  if (me != owner_r && me != owner_s) return;
+  double* a = local.data();
+  const long cols = local.GetCols();
+  if (owner_r == owner_s) {
+    std::swap_ranges(a + localIndex(r, block, procs) * cols + begin,
+                     a + localIndex(r, block, procs) * cols + end,
+                     a + localIndex(s, block, procs) * cols + begin);
+    return;
+  }
+  int mine = me == owner_r ? r : s;
+  int partner = grid.RankOf(me == owner_r ? owner_s : owner_r, grid.GetCol());
+  double* row = a + localIndex(mine, block, procs) * cols;
+  grid.GetTransport().Send(partner, kTagSwap, row + begin, end - begin);
+  std::vector<double> theirs = grid.GetTransport().Receive(partner, kTagSwap);
+  std::copy(theirs.begin(), theirs.end(), row + begin);
+}
+
+// rows [row_begin, row_end) and columns [col_begin, col_end) of local,
+// packed row by row
+std::vector<double> pack(const S21Matrix& local, int row_begin, int row_end,
+                         int col_begin, int col_end) {
+  std::vector<double> result;
+  const double* a = local.data();
+  const long cols = local.GetCols();
+  result.reserve(static_cast<std::size_t>(std::max(0, row_end - row_begin)) *
+                 std::max(0, col_end - col_begin));
+  for (auto r = row_begin; r < row_end; r++) {
+    result.insert(result.end(), a + r * cols + col_begin,
+                  a + r * cols + col_end);
+  }
+  return result;
+}
+}  // namespace
+
+// grid
+
+S21ProcessGrid::S21ProcessGrid(S21Transport& transport, int rows, int cols)
+    : transport_(&transport), rows_(rows), cols_(cols) {
+  if (rows < 1 || cols < 1 || rows * cols != transport.Size()) {
+    throw std::invalid_argument(
+        "Incorrect input, the grid must have one position per rank");
+  }
+}
+
+S21ProcessGrid::S21ProcessGrid(S21Transport& transport)
+    : S21ProcessGrid(transport, squarestRows(transport.Size()),
+                     transport.Size() / squarestRows(transport.Size())) {}
+
+S21Transport& S21ProcessGrid::GetTransport() const noexcept {
+  return *transport_;
+}
+
+int S21ProcessGrid::GetRows() const noexcept { return rows_; }
+
+int S21ProcessGrid::GetCols() const noexcept { return cols_; }
+
+int S21ProcessGrid::GetRow() const noexcept {
+  return transport_->Rank() / cols_;
+}
+
+int S21ProcessGrid::GetCol() const noexcept {
+  return transport_->Rank() % cols_;
+}
+
+int S21ProcessGrid::RankOf(int row, int col) const noexcept {
+  return row * cols_ + col;
+}
+
+void S21ProcessGrid::broadcast(const std::vector<int>& ranks, int root,
+                               std::vector<double>& data, int tag) const {
+  const int size = static_cast<int>(ranks.size());
+  const int me = static_cast<int>(
+      std::find(ranks.begin(), ranks.end(), transport_->Rank()) -
+      ranks.begin());
+  // positions relative to the root, a rank receives from the one that
+  // differs in its lowest set bit and sends along the lower bits
+  const int relative = (me - root + size) % size;
+  int mask = 1;
+  while (mask < size) {
+    if (relative & mask) {
+      data = transport_->Receive(ranks[(relative - mask + root) % size], tag);
+      break;
+    }
+    mask <<= 1;
+  }
+  for (mask >>= 1; mask > 0; mask >>= 1) {
+    if (relative + mask < size) {
+      transport_->Send(ranks[(relative + mask + root) % size], tag,
+                       data.data(), data.size());
+    }
+  }
+}
+
+std::vector<std::vector<double>> S21ProcessGrid::allGather(
+    const std::vector<int>& ranks, const std::vector<double>& data,
+    int tag) const {
+  std::vector<std::vector<double>> result(ranks.size());
+  for (int rank : ranks) {
+    if (rank != transport_->Rank()) {
+      transport_->Send(rank, tag, data.data(), data.size());
+    }
+  }
+  for (std::size_t i = 0; i < ranks.size(); i++) {
+    result[i] = ranks[i] == transport_->Rank()
+                    ? data
+                    : transport_->Receive(ranks[i], tag);
+  }
+  return result;
+}
+
+void S21ProcessGrid::BroadcastRow(int root_col, std::vector<double>& data,
+                                  int tag) const {
+  std::vector<int> ranks(cols_);
+  for (auto col = 0; col < cols_; col++) ranks[col] = RankOf(GetRow(), col);
+  broadcast(ranks, root_col, data, tag);
+}
+
+void S21ProcessGrid::BroadcastCol(int root_row, std::vector<double>& data,
+                                  int tag) const {
+  std::vector<int> ranks(rows_);
+  for (auto row = 0; row < rows_; row++) ranks[row] = RankOf(row, GetCol());
+  broadcast(ranks, root_row, data, tag);
+}
+
+void S21ProcessGrid::Broadcast(int root, std::vector<double>& data,
+                               int tag) const {
+  std::vector<int> ranks(rows_ * cols_);
+  for (auto rank = 0; rank < rows_ * cols_; rank++) ranks[rank] = rank;
+  broadcast(ranks, root, data, tag);
+}
+
+std::vector<std::vector<double>> S21ProcessGrid::AllGatherCol(
+    const std::vector<double>& data, int tag) const {
+  std::vector<int> ranks(rows_);
+  for (auto row = 0; row < rows_; row++) ranks[row] = RankOf(row, GetCol());
+  return allGather(ranks, data, tag);
+}
+
+std::vector<std::vector<double>> S21ProcessGrid::AllGather(
+    const std::vector<double>& data, int tag) const {
+  std::vector<int> ranks(rows_ * cols_);
+  for (auto rank = 0; rank < rows_ * cols_; rank++) ranks[rank] = rank;
+  return allGather(ranks, data, tag);
+}
+
+void S21ProcessGrid::Barrier() const { AllGather({}, kTagBarrier); }
+
+// matrix
+
+S21DistributedMatrix::S21DistributedMatrix(const S21ProcessGrid& grid,
+                                           int rows, int cols, int block)
+    : grid_(&grid), rows_(rows), cols_(cols), block_(block) {
+  if (rows < 0 || cols < 0) {
+    throw std::invalid_argument("Rows and columns must be positive");
+  }
+  if (block < 1) throw std::invalid_argument("Block size must be positive");
+  local_ = S21Matrix(localCount(rows, block, grid.GetRows(), grid.GetRow()),
+                     localCount(cols, block, grid.GetCols(), grid.GetCol()));
+}
+
+S21DistributedMatrix S21DistributedMatrix::FromGenerator(
+    const S21ProcessGrid& grid, int rows, int cols, int block,
+    const std::function<double(int, int)>& generator) {
+  S21DistributedMatrix result(grid, rows, cols, block);
+  S21Matrix& local = result.local_;
+  for (auto i = 0; i < local.GetRows(); i++) {
+    int row = globalIndex(i, block, grid.GetRows(), grid.GetRow());
+    for (auto j = 0; j < local.GetCols(); j++) {
+      local(i, j) =
+          generator(row, globalIndex(j, block, grid.GetCols(), grid.GetCol()));
+    }
+  }
+  return result;
+}
+
+S21DistributedMatrix S21DistributedMatrix::Scatter(const S21ProcessGrid& grid,
+                                                   const S21Matrix& matrix,
+                                                   int block) {
+  const bool root = grid.GetTransport().Rank() == 0;
+  std::vector<double> shape;
+  if (root) shape = {1.0 * matrix.GetRows(), 1.0 * matrix.GetCols()};
+  grid.Broadcast(0, shape, kTagScatter);
+  S21DistributedMatrix result(grid, static_cast<int>(shape[0]),
+                              static_cast<int>(shape[1]), block);
+  if (!root) {
+    std::vector<double> mine = grid.GetTransport().Receive(0, kTagScatter);
+    std::copy(mine.begin(), mine.end(), result.local_.data());
+    return result;
+  }
+  for (auto rank = grid.GetRows() * grid.GetCols() - 1; rank >= 0; rank--) {
+    const int row = rank / grid.GetCols();
+    const int col = rank % grid.GetCols();
+    const int rows = localCount(result.rows_, block, grid.GetRows(), row);
+    const int cols = localCount(result.cols_, block, grid.GetCols(), col);
+    std::vector<double> tiles(static_cast<std::size_t>(rows) * cols);
+    for (auto i = 0; i < rows; i++) {
+      int global = globalIndex(i, block, grid.GetRows(), row);
+      for (auto j = 0; j < cols; j++) {
+        tiles[static_cast<std::size_t>(i) * cols + j] =
+            matrix(global, globalIndex(j, block, grid.GetCols(), col));
+      }
+    }
+    if (rank == 0) {
+      std::copy(tiles.begin(), tiles.end(), result.local_.data());
+    } else {
+      grid.GetTransport().Send(rank, kTagScatter, tiles.data(), tiles.size());
+    }
+  }
+  return result;
+}
+
+S21Matrix S21DistributedMatrix::Gather() const {
+  const S21ProcessGrid& grid = *grid_;
+  const double* mine = local_.data();
+  if (grid.GetTransport().Rank() != 0) {
+    grid.GetTransport().Send(
+        0, kTagGather, mine,
+        static_cast<std::size_t>(local_.GetRows()) * local_.GetCols());
+    return S21Matrix();
+  }
+  S21Matrix result(rows_, cols_);
+  for (auto rank = 0; rank < grid.GetRows() * grid.GetCols(); rank++) {
+    const int row = rank / grid.GetCols();
+    const int col = rank % grid.GetCols();
+    const int rows = localCount(rows_, block_, grid.GetRows(), row);
+    const int cols = localCount(cols_, block_, grid.GetCols(), col);
+    std::vector<double> tiles =
+        rank == 0
+            ? std::vector<double>(mine, mine + static_cast<long>(rows) * cols)
+            : grid.GetTransport().Receive(rank, kTagGather);
+    for (auto i = 0; i < rows; i++) {
+      int global = globalIndex(i, block_, grid.GetRows(), row);
+      for (auto j = 0; j < cols; j++) {
+        result(global, globalIndex(j, block_, grid.GetCols(), col)) =
+            tiles[static_cast<std::size_t>(i) * cols + j];
+      }
+    }
+  }
+  return result;
+}
+
+const S21ProcessGrid& S21DistributedMatrix::GetGrid() const noexcept {
+  return *grid_;
+}
+
+int S21DistributedMatrix::GetRows() const noexcept { return rows_; }
+
+int S21DistributedMatrix::GetCols() const noexcept { return cols_; }
+
+int S21DistributedMatrix::GetBlock() const noexcept { return block_; }
+
+const S21Matrix& S21DistributedMatrix::GetLocal() const noexcept {
+  return local_;
+}
+
+S21Matrix& S21DistributedMatrix::GetLocal() noexcept { return local_; }
+
+void S21DistributedMatrix::MulMatrix(const S21DistributedMatrix& other) {
+  if (cols_ != other.rows_) {
+    throw std::logic_error(
+        "Incorrect input, the number of inputed rows must be equal to the "
+        "number of columns of the first matrix.");
+  }
+  if (grid_ != other.grid_ || block_ != other.block_) {
+    throw std::logic_error(
+        "Incorrect input, the matrices are distributed differently.");
+  }
+  const S21ProcessGrid& grid = *grid_;
+  S21DistributedMatrix result(grid, rows_, other.cols_, block_);
+  const int rows = local_.GetRows();
+  const int cols = other.local_.GetCols();
+  for (auto k0 = 0; k0 < cols_; k0 += block_) {
+    const int width = std::min(block_, cols_ - k0);
+    const int owner_col = owner(k0, block_, grid.GetCols());
+    const int owner_row = owner(k0, block_, grid.GetRows());
+    std::vector<double> a_panel, b_panel;
+    if (grid.GetCol() == owner_col) {
+      int first = localIndex(k0, block_, grid.GetCols());
+      a_panel = pack(local_, 0, rows, first, first + width);
+    }
+    grid.BroadcastRow(owner_col, a_panel, kTagSummaA);
+    if (grid.GetRow() == owner_row) {
+      int first = localIndex(k0, block_, grid.GetRows());
+      b_panel = pack(other.local_, first, first + width, 0, cols);
+    }
+    grid.BroadcastCol(owner_row, b_panel, kTagSummaB);
+    if (rows > 0 && cols > 0) {
+      result.local_ += view(a_panel.data(), rows, width, width) *
+                       view(b_panel.data(), width, cols, cols);
+    }
+  }
+  *this = std::move(result);
+}
+
+double S21DistributedMatrix::Determinant() const {
+  return S21DistributedLU(*this).Determinant();
+}
+
+S21DistributedMatrix S21DistributedMatrix::InverseMatrix() const {
+  return S21DistributedLU(*this).Inverse();
+}
+
+// LU
+
+S21DistributedLU::S21DistributedLU(const S21DistributedMatrix& matrix)
+    : lu_(matrix), swaps_(matrix.rows_), singular_(false) {
+  if (matrix.rows_ != matrix.cols_) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  const S21ProcessGrid& grid = *lu_.grid_;
+  const int n = lu_.rows_;
+  const int nb = lu_.block_;
+  const int procs_rows = grid.GetRows();
+  const int procs_cols = grid.GetCols();
+  const int my_row = grid.GetRow();
+  const int my_col = grid.GetCol();
+  S21Matrix& local = lu_.local_;
+  const int rows = local.GetRows();
+  const int cols = local.GetCols();
+  double* a = local.data();
+  for (auto j = 0; j < n; j++) swaps_[j] = j;
+
+  for (auto k0 = 0; k0 < n; k0 += nb) {
+    const int k1 = std::min(n, k0 + nb);
+    const int width = k1 - k0;
+    const int panel_col = owner(k0, nb, procs_cols);
+    const int panel_row = owner(k0, nb, procs_rows);
+    const bool in_panel = my_col == panel_col;
+    const int c0 = in_panel ? localIndex(k0, nb, procs_cols) : 0;
+
+    if (in_panel) {
+      for (auto j = k0; j < k1; j++) {
+        const int cj = c0 + (j - k0);
+        // the largest candidate of every grid row, ties go to the lower row
+        // so that every rank picks the same one
+        double best = 0.0;
+        int candidate = -1;
+        for (auto r = localCount(j, nb, procs_rows, my_row); r < rows; r++) {
+          double value = std::fabs(a[static_cast<long>(r) * cols + cj]);
+          if (candidate < 0 || value > best) {
+            best = value;
+            candidate = globalIndex(r, nb, procs_rows, my_row);
+          }
+        }
+        int pivot = -1;
+        double largest = 0.0;
+        for (const auto& offer : grid.AllGatherCol(
+                 {best, static_cast<double>(candidate)}, kTagPivot)) {
+          int row = static_cast<int>(offer[1]);
+          if (row < 0) continue;
+          if (pivot < 0 || offer[0] > largest ||
+              (offer[0] == largest && row < pivot)) {
+            largest = offer[0];
+            pivot = row;
+          }
+        }
+        if (largest == 0.0) {
+          singular_ = true;
+          continue;
+        }
+        swaps_[j] = pivot;
+        exchangeRows(grid, local, nb, j, pivot, c0, c0 + width);
+        // row j from column j to the end of the panel
+        const int holder = owner(j, nb, procs_rows);
+        std::vector<double> pivot_row;
+        if (my_row == holder) {
+          int r = localIndex(j, nb, procs_rows);
+          pivot_row = pack(local, r, r + 1, cj, c0 + width);
+        }
+        grid.BroadcastCol(holder, pivot_row, kTagPivotRow);
+        for (auto r = localCount(j + 1, nb, procs_rows, my_row); r < rows;
+             r++) {
+          double* row = a + static_cast<long>(r) * cols;
+          double factor = row[cj] /= pivot_row[0];
+          for (auto c = 1; c < static_cast<int>(pivot_row.size()); c++) {
+            row[cj + c] -= factor * pivot_row[c];
+          }
+        }
+      }
+    }
+
+    // the interchanges of the panel reach every grid column
+    std::vector<double> swaps;
+    if (in_panel) {
+      swaps.assign(swaps_.begin() + k0, swaps_.begin() + k1);
+      swaps.push_back(singular_ ? 1.0 : 0.0);
+    }
+    grid.BroadcastRow(panel_col, swaps, kTagSwaps);
+    for (auto j = k0; j < k1; j++) swaps_[j] = static_cast<int>(swaps[j - k0]);
+    singular_ = singular_ || swaps.back() != 0.0;
+    for (auto j = k0; j < k1; j++) {
+      if (in_panel) {
+        exchangeRows(grid, local, nb, j, swaps_[j], 0, c0);
+        exchangeRows(grid, local, nb, j, swaps_[j], c0 + width, cols);
+      } else {
+        exchangeRows(grid, local, nb, j, swaps_[j], 0, cols);
+      }
+    }
+
+    // L11 and L21 along the grid rows
+    const int panel_first = localCount(k0, nb, procs_rows, my_row);
+    std::vector<double> panel;
+    if (in_panel) panel = pack(local, panel_first, rows, c0, c0 + width);
+    grid.BroadcastRow(panel_col, panel, kTagPanel);
+
+    // U12 = L11^-1 A12 on the grid row of the block row, then down the
+    // grid columns
+    const int trailing_col = localCount(k1, nb, procs_cols, my_col);
+    const int trailing = cols - trailing_col;
+    std::vector<double> block_row;
+    if (my_row == panel_row) {
+      for (auto r = 1; r < width; r++) {
+        double* row = a + static_cast<long>(panel_first + r) * cols;
+        for (auto q = 0; q < r; q++) {
+          double factor = panel[r * width + q];
+          const double* above = a + static_cast<long>(panel_first + q) * cols;
+          for (auto c = trailing_col; c < cols; c++) {
+            row[c] -= factor * above[c];
+          }
+        }
+      }
+      block_row = pack(local, panel_first, panel_first + width, trailing_col,
+                       cols);
+    }
+    grid.BroadcastCol(panel_row, block_row, kTagBlockRow);
+
+    // A22 -= L21 * U12
+    const int trailing_row = localCount(k1, nb, procs_rows, my_row);
+    if (trailing_row < rows && trailing > 0) {
+      S21MatrixView target =
+          view(a + static_cast<long>(trailing_row) * cols + trailing_col,
+               rows - trailing_row, trailing, cols);
+      target -= view(panel.data() +
+                         static_cast<long>(trailing_row - panel_first) * width,
+                     rows - trailing_row, width, width) *
+                view(block_row.data(), width, trailing, trailing);
+    }
+  }
+}
+
+const S21DistributedMatrix& S21DistributedLU::GetFactors() const noexcept {
+  return lu_;
+}
+
+const std::vector<int>& S21DistributedLU::GetSwaps() const noexcept {
+  return swaps_;
+}
+
+bool S21DistributedLU::IsSingular() const noexcept { return singular_; }
+
+double S21DistributedLU::Determinant() const {
+  if (singular_) return 0.0;
+  const S21ProcessGrid& grid = *lu_.grid_;
+  const int nb = lu_.block_;
+  double product = 1.0;
+  for (auto i = 0; i < lu_.rows_; i++) {
+    if (owner(i, nb, grid.GetRows()) == grid.GetRow() &&
+        owner(i, nb, grid.GetCols()) == grid.GetCol()) {
+      product *= lu_.local_(localIndex(i, nb, grid.GetRows()),
+                            localIndex(i, nb, grid.GetCols()));
+    }
+  }
+  double result = 1.0;
+  for (const auto& part : grid.AllGather({product}, kTagDeterminant)) {
+    result *= part[0];
+  }
+  for (auto j = 0; j < lu_.rows_; j++) {
+    if (swaps_[j] != j) result = -result;
+  }
+  return result;
+}
+
+S21DistributedMatrix S21DistributedLU::Solve(
+    const S21DistributedMatrix& rhs) const {
+  if (rhs.rows_ != lu_.rows_) {
+    throw std::logic_error(
+        "Incorrect input, the right-hand side must have as many rows as the "
+        "matrix.");
+  }
+  if (rhs.grid_ != lu_.grid_ || rhs.block_ != lu_.block_) {
+    throw std::logic_error(
+        "Incorrect input, the matrices are distributed differently.");
+  }
+  if (singular_) throw std::logic_error("The matrix is singular.");
+  const S21ProcessGrid& grid = *lu_.grid_;
+  const int n = lu_.rows_;
+  const int nb = lu_.block_;
+  const int procs_rows = grid.GetRows();
+  const int procs_cols = grid.GetCols();
+  const int my_row = grid.GetRow();
+  const int my_col = grid.GetCol();
+  const S21Matrix& factors = lu_.local_;
+  S21DistributedMatrix result = rhs;
+  S21Matrix& local = result.local_;
+  const int rows = local.GetRows();
+  const int cols = local.GetCols();
+  for (auto j = 0; j < n; j++) {
+    exchangeRows(grid, local, nb, j, swaps_[j], 0, cols);
+  }
+  double* x = local.data();
+
+  // one block row of X at a time: the diagonal block of the factors goes
+  // along its grid row, the solved block row down the grid columns, and the
+  // block column of the factors along the grid rows for the update
+  auto sweep = [&](int k0, bool lower) {
+    const int width = std::min(nb, n - k0);
+    const int panel_col = owner(k0, nb, procs_cols);
+    const int panel_row = owner(k0, nb, procs_rows);
+    const int block_first = localCount(k0, nb, procs_rows, my_row);
+    const int first_col =
+        my_col == panel_col ? localIndex(k0, nb, procs_cols) : 0;
+    std::vector<double> solved;
+    if (my_row == panel_row) {
+      std::vector<double> diagonal;
+      if (my_col == panel_col) {
+        diagonal = pack(factors, block_first, block_first + width, first_col,
+                        first_col + width);
+      }
+      grid.BroadcastRow(panel_col, diagonal, kTagDiagonal);
+      for (auto step = 0; step < width; step++) {
+        int r = lower ? step : width - 1 - step;
+        double* row = x + static_cast<long>(block_first + r) * cols;
+        int q_begin = lower ? 0 : r + 1;
+        int q_end = lower ? r : width;
+        for (auto q = q_begin; q < q_end; q++) {
+          double factor = diagonal[r * width + q];
+          const double* other = x + static_cast<long>(block_first + q) * cols;
+          for (auto c = 0; c < cols; c++) row[c] -= factor * other[c];
+        }
+        if (!lower) {
+          for (auto c = 0; c < cols; c++) row[c] /= diagonal[r * width + r];
+        }
+      }
+      solved = pack(local, block_first, block_first + width, 0, cols);
+    }
+    grid.BroadcastCol(panel_row, solved, kTagSolve);
+    // the rows below the block for L, above it for U
+    const int begin = lower ? localCount(k0 + width, nb, procs_rows, my_row)
+                            : 0;
+    const int end = lower ? rows : block_first;
+    std::vector<double> column;
+    if (my_col == panel_col) {
+      column = pack(factors, begin, end, first_col, first_col + width);
+    }
+    grid.BroadcastRow(panel_col, column, kTagPanel);
+    if (begin < end && cols > 0) {
+      S21MatrixView target =
+          view(x + static_cast<long>(begin) * cols, end - begin, cols, cols);
+      target -= view(column.data(), end - begin, width, width) *
+                view(solved.data(), width, cols, cols);
+    }
+  };
+  for (auto k0 = 0; k0 < n; k0 += nb) sweep(k0, true);
+  for (auto k0 = (n - 1) / nb * nb; k0 >= 0 && n > 0; k0 -= nb) {
+    sweep(k0, false);
+  }
+  return result;
+}
+
+S21DistributedMatrix S21DistributedLU::Inverse() const {
+  return Solve(S21DistributedMatrix::FromGenerator(
+      *lu_.grid_, lu_.rows_, lu_.rows_, lu_.block_,
+      [](int i, int j) { return i == j ? 1.0 : 0.0; }));
+}
@@ -0,0 +1,124 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_DISTRIBUTED_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_DISTRIBUTED_H_
+
+#include <functional>
+#include <vector>
+
+#include "s21_matrix/s21_matrix_oop.h"
+#include "s21_matrix/s21_transport.h"
+
+// everything below is collective: every rank of the transport calls the
+// same operations in the same order
+
+// ranks of a transport arranged as a rows x cols grid, rank = row * cols +
+// col
+class S21ProcessGrid {
+ public:
+  // throws std::invalid_argument unless rows * cols is the transport size
+  S21ProcessGrid(S21Transport& transport, int rows, int cols);
+  // the squarest grid with at least as many columns as rows
+  explicit S21ProcessGrid(S21Transport& transport);
+
+  S21Transport& GetTransport() const noexcept;
+  int GetRows() const noexcept;
+  int GetCols() const noexcept;
+  // position of this rank
+  int GetRow() const noexcept;
+  int GetCol() const noexcept;
+  int RankOf(int row, int col) const noexcept;
+
+  // binomial tree broadcasts of the data of the root to the other ranks of
+  // its grid row, its grid column or the whole grid
+  void BroadcastRow(int root_col, std::vector<double>& data, int tag) const;
+  void BroadcastCol(int root_row, std::vector<double>& data, int tag) const;
+  void Broadcast(int root, std::vector<double>& data, int tag) const;
+  // the data of every rank of the grid column, by grid row
+  std::vector<std::vector<double>> AllGatherCol(
+      const std::vector<double>& data, int tag) const;
+  // the data of every rank, by rank
+  std::vector<std::vector<double>> AllGather(const std::vector<double>& data,
+                                             int tag) const;
+  void Barrier() const;
+
+ private:
+  S21Transport* transport_;
+  int rows_, cols_;
+  void broadcast(const std::vector<int>& ranks, int root,
+                 std::vector<double>& data, int tag) const;
+  std::vector<std::vector<double>> allGather(const std::vector<int>& ranks,
+                                             const std::vector<double>& data,
+                                             int tag) const;
+};
+
+// matrix split into block x block tiles dealt 2D block-cyclically over a
+// process grid: tile (i, j) lives on grid position (i % rows, j % cols), and
+// each rank keeps its tiles packed in a local row-major matrix
+class S21DistributedMatrix {
+ public:
+  // zero matrix, throws std::invalid_argument for negative sizes or a block
+  // below 1
+  S21DistributedMatrix(const S21ProcessGrid& grid, int rows, int cols,
+                       int block);
+  // every rank computes its own elements, nothing is sent
+  static S21DistributedMatrix FromGenerator(
+      const S21ProcessGrid& grid, int rows, int cols, int block,
+      const std::function<double(int, int)>& generator);
+  // distributes matrix as given on rank 0, the argument of the other ranks
+  // is ignored
+  static S21DistributedMatrix Scatter(const S21ProcessGrid& grid,
+                                      const S21Matrix& matrix, int block);
+  // the whole matrix on rank 0, an empty one elsewhere
+  S21Matrix Gather() const;
+
+  const S21ProcessGrid& GetGrid() const noexcept;
+  int GetRows() const noexcept;
+  int GetCols() const noexcept;
+  int GetBlock() const noexcept;
+  // the tiles of this rank
+  const S21Matrix& GetLocal() const noexcept;
+  S21Matrix& GetLocal() noexcept;
+
+  // SUMMA: for every block column of this matrix and block row of other,
+  // the owners broadcast them along grid rows and grid columns and every
+  // rank adds the product of what it received to its tiles
+  void MulMatrix(const S21DistributedMatrix& other);
+  // through S21DistributedLU
+  double Determinant() const;
+  S21DistributedMatrix InverseMatrix() const;
+
+ private:
+  friend class S21DistributedLU;
+  const S21ProcessGrid* grid_;
+  int rows_, cols_, block_;
+  S21Matrix local_;
+};
+
+// LU with partial pivoting of a distributed square matrix, P * A = L * U
+// kept distributed like the matrix (ScaLAPACK's pdgetrf scheme): a grid
+// column factors each block column, pivot rows are found with a gather
+// over that grid column and swapped between grid rows, then the panel and
+// the block row of U are broadcast for the update of the trailing matrix
+class S21DistributedLU {
+ public:
+  explicit S21DistributedLU(const S21DistributedMatrix& matrix);
+
+  const S21DistributedMatrix& GetFactors() const noexcept;
+  // row r was interchanged with row GetSwaps()[r] at elimination step r,
+  // the same on every rank
+  const std::vector<int>& GetSwaps() const noexcept;
+  // whether elimination met an exactly zero pivot column
+  bool IsSingular() const noexcept;
+
+  double Determinant() const;
+  // X with A * X = rhs, rhs distributed over the same grid with the same
+  // block; throws std::logic_error if A is singular
+  S21DistributedMatrix Solve(const S21DistributedMatrix& rhs) const;
+  S21DistributedMatrix Inverse() const;
+
+ private:
+  S21DistributedMatrix lu_;
+  std::vector<int> swaps_;
+  bool singular_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_DISTRIBUTED_H_
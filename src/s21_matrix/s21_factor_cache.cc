@@ -0,0 +1,147 @@
+#include "s21_matrix/s21_factor_cache.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+// capacitance matrices with a smaller reciprocal condition number count as
+// singular
+constexpr double kSingularRcond = std::numeric_limits<double>::epsilon();
+}  // namespace
+
+S21MatrixFactorCache::S21MatrixFactorCache(const S21Matrix& matrix,
+                                           double tolerance)
+    : matrix_(matrix),
+      lu_(matrix_),
+      determinant_(0.0),
+      tolerance_(tolerance),
+      baseline_(0.0),
+      updates_(0) {
+  useFactors();
+}
+
+const S21Matrix& S21MatrixFactorCache::GetMatrix() const noexcept {
+  return matrix_;
+}
+
+const S21LU& S21MatrixFactorCache::GetFactors() const noexcept { return lu_; }
+
+int S21MatrixFactorCache::GetUpdatesSinceFactorization() const noexcept {
+  return updates_;
+}
+
+double S21MatrixFactorCache::Determinant() const noexcept {
+  return determinant_;
+}
+
+const S21Matrix& S21MatrixFactorCache::InverseMatrix() const {
+  if (lu_.IsSingular()) {
+    throw std::logic_error("Zero determinant.");
+  }
+  return inverse_;
+}
+
+void S21MatrixFactorCache::Refactorize() {
+  lu_ = S21LU(matrix_);
+  useFactors();
+}
+
+void S21MatrixFactorCache::useFactors() {
+  updates_ = 0;
+  determinant_ = lu_.Determinant();
+  if (lu_.IsSingular()) {
+    inverse_ = S21Matrix();
+    baseline_ = 0.0;
+  } else {
+    inverse_ = lu_.Inverse();
+    baseline_ = residual();
+  }
+}
+
+double S21MatrixFactorCache::residual() const {
+  const int n = matrix_.GetRows();
+  S21Matrix probe = S21Matrix::FromGenerator(
+      n, 1, [n](int i, int) { return 1.0 + static_cast<double>(i) / n; });
+  S21Matrix error = matrix_ * (inverse_ * probe) - probe;
+  double norm = 0.0;
+  for (auto i = 0; i < n; i++) norm = std::max(norm, std::fabs(error(i, 0)));
+  // the probe's infinity norm is below 2
+  return norm / 2.0;
+}
+
+void S21MatrixFactorCache::Update(const S21Matrix& u, const S21Matrix& v) {
+  const int n = matrix_.GetRows();
+  if (u.GetRows() != n || v.GetRows() != n || u.GetCols() != v.GetCols()) {
+    throw std::logic_error(
+        "Incorrect input, the update factors must be n x k matrices.");
+  }
+  const int k = u.GetCols();
+  S21Matrix vt = v.Transpose();
+  matrix_ += u * vt;
+  if (lu_.IsSingular()) {
+    // nothing to update from, the new matrix may well be regular
+    Refactorize();
+    return;
+  }
+
+  // A' = A + U V^T, C = I + V^T A^-1 U:
+  // det(A') = det(A) det(C), A'^-1 = A^-1 - A^-1 U C^-1 V^T A^-1
+  S21Matrix z = inverse_ * u;
+  S21LU capacitance(S21Matrix::Identity(k) + vt * z);
+  // scale-free test on C itself, tolerance_ only bounds the residual; a C
+  // that is singular only to rounding is left to the residual check
+  if (capacitance.IsSingular(kSingularRcond)) {
+    Refactorize();
+    return;
+  }
+  determinant_ *= capacitance.Determinant();
+  inverse_ -= z * capacitance.Solve(vt * inverse_);
+  updates_++;
+  if (residual() > std::max(tolerance_, 10.0 * baseline_)) {
+    Refactorize();
+  }
+}
+
+void S21MatrixFactorCache::SetRow(int row, const S21Matrix& values) {
+  const int n = matrix_.GetRows();
+  if (row < 0 || row >= n) {
+    throw std::out_of_range("Rows and columns out of range.");
+  }
+  if (values.GetRows() != 1 || values.GetCols() != n) {
+    throw std::logic_error("Incorrect input, the row must be a 1 x n matrix.");
+  }
+  S21Matrix u(n, 1);
+  S21Matrix v(n, 1);
+  u(row, 0) = 1.0;
+  for (auto j = 0; j < n; j++) v(j, 0) = values(0, j) - matrix_(row, j);
+  Update(u, v);
+}
+
+void S21MatrixFactorCache::SetColumn(int col, const S21Matrix& values) {
+  const int n = matrix_.GetRows();
+  if (col < 0 || col >= n) {
+    throw std::out_of_range("Rows and columns out of range.");
+  }
+  if (values.GetRows() != n || values.GetCols() != 1) {
+    throw std::logic_error(
+        "Incorrect input, the column must be an n x 1 matrix.");
+  }
+  S21Matrix u(n, 1);
+  S21Matrix v(n, 1);
+  v(col, 0) = 1.0;
+  for (auto i = 0; i < n; i++) u(i, 0) = values(i, 0) - matrix_(i, col);
+  Update(u, v);
+}
+
+void S21MatrixFactorCache::SetElement(int row, int col, double value) {
+  const int n = matrix_.GetRows();
+  if (row < 0 || col < 0 || row >= n || col >= n) {
+    throw std::out_of_range("Rows and columns out of range.");
+  }
+  S21Matrix u(n, 1);
+  S21Matrix v(n, 1);
+  u(row, 0) = value - matrix_(row, col);
+  v(col, 0) = 1.0;
+  Update(u, v);
+}
@@ -0,0 +1,51 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_FACTOR_CACHE_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_FACTOR_CACHE_H_
+
+#include "s21_matrix/s21_lu.h"
+#include "s21_matrix/s21_matrix_oop.h"
+
+// square matrix kept together with its determinant and inverse; low-rank
+// modifications update both in O(n^2 k) with the Sherman-Morrison-Woodbury
+// identity and the matrix determinant lemma instead of starting over
+class S21MatrixFactorCache {
+ public:
+  // refactorizes once the relative residual of the maintained inverse,
+  // checked after every update, exceeds tolerance
+  explicit S21MatrixFactorCache(const S21Matrix& matrix,
+                                double tolerance = 1e-9);
+
+  const S21Matrix& GetMatrix() const noexcept;
+  // factors of the last full factorization, older than the updates since;
+  // a singular matrix is refactorized on every update
+  const S21LU& GetFactors() const noexcept;
+  int GetUpdatesSinceFactorization() const noexcept;
+
+  double Determinant() const noexcept;
+  // throws std::logic_error if the matrix is singular
+  const S21Matrix& InverseMatrix() const;
+
+  // A += u * v^T with u and v of size n x k
+  void Update(const S21Matrix& u, const S21Matrix& v);
+  // replaces row or column by a 1 x n or n x 1 matrix, rank-1 updates
+  void SetRow(int row, const S21Matrix& values);
+  void SetColumn(int col, const S21Matrix& values);
+  void SetElement(int row, int col, double value);
+  // recomputes factors, determinant and inverse from the current matrix
+  void Refactorize();
+
+ private:
+  S21Matrix matrix_;
+  S21LU lu_;
+  S21Matrix inverse_;
+  double determinant_;
+  double tolerance_;
+  // residual right after the last factorization, the rounding floor
+  double baseline_;
+  int updates_;
+  // determinant and inverse from freshly computed lu_
+  void useFactors();
+  // relative residual of inverse_ against matrix_ on a fixed probe vector
+  double residual() const;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_FACTOR_CACHE_H_
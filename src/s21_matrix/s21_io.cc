@@ -0,0 +1,497 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "s21_matrix/s21_matrix_oop.h"
+#include "s21_matrix/s21_thread_pool.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace {
+// size of the pieces a file is cut into, reading or writing
+constexpr long kChunkBytes = 1L << 18;
+
+// the whole file, read-only, mapped where mmap is available
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  const char* begin() const noexcept { return data_; }
+  const char* end() const noexcept { return data_ + size_; }
+
+ private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+#ifndef __linux__
+  std::string copy_;
+#endif
+};
+
+#ifdef __linux__
+MappedFile::MappedFile(const std::string& path) {
+  int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) throw std::runtime_error("Cannot open " + path);
+  struct stat status;
+  if (fstat(descriptor, &status) != 0) {
+    close(descriptor);
+    throw std::runtime_error("Cannot open " + path);
+  }
+  size_ = static_cast<std::size_t>(status.st_size);
+  if (size_ > 0) {
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (data == MAP_FAILED) throw std::runtime_error("Cannot map " + path);
+    // the chunks are read at once from several threads
+    madvise(data, size_, MADV_WILLNEED);
+    data_ = static_cast<const char*>(data);
+  } else {
+    close(descriptor);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (data_) munmap(const_cast<char*>(data_), size_);
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) throw std::runtime_error("Cannot open " + path);
+  copy_.assign(std::istreambuf_iterator<char>(stream),
+               std::istreambuf_iterator<char>());
+  data_ = copy_.data();
+  size_ = copy_.size();
+}
+
+MappedFile::~MappedFile() {}
+#endif
+
+struct Line {
+  const char* begin;
+  const char* end;
+};
+
+// blanks around numbers, except the delimiter itself
+bool isSpace(char c, char delimiter) {
+  return (c == ' ' || c == '\t' || c == '\r') && c != delimiter;
+}
+
+const char* skipSpaces(const char* p, const char* end, char delimiter = 0) {
+  while (p < end && isSpace(*p, delimiter)) p++;
+  return p;
+}
+
+// moves p past the next line that is neither blank nor, with comments, a
+// Matrix Market comment, and returns it without its newline
+bool nextLine(const char*& p, const char* end, bool comments, Line& line) {
+  while (p < end) {
+    auto newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    line = {p, newline ? newline : end};
+    p = newline ? newline + 1 : end;
+    const char* first = skipSpaces(line.begin, line.end);
+    if (first != line.end && !(comments && *first == '%')) return true;
+  }
+  return false;
+}
+
+// [begin, end) cut at line starts into pieces of about kChunkBytes
+std::vector<const char*> splitLines(const char* begin, const char* end) {
+  const long parts = (end - begin) / kChunkBytes + 1;
+  std::vector<const char*> bounds{begin};
+  for (auto part = 1; part < parts; part++) {
+    const char* p =
+        std::max(bounds.back(), begin + (end - begin) * part / parts);
+    auto newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    bounds.push_back(newline ? newline + 1 : end);
+  }
+  bounds.push_back(end);
+  return bounds;
+}
+
+void forEachChunk(long chunks, const std::function<void(long)>& body) {
+  S21ThreadPool::Instance().ParallelFor(chunks, 1, [&](long begin, long end) {
+    for (auto chunk = begin; chunk < end; chunk++) body(chunk);
+  });
+}
+
+// index of the first line of every chunk among all the lines that count,
+// the last entry being the total; the chunks are counted in parallel
+std::vector<long> lineOffsets(const std::vector<const char*>& bounds,
+                              bool comments) {
+  std::vector<long> offsets(bounds.size(), 0);
+  forEachChunk(bounds.size() - 1, [&](long chunk) {
+    const char* p = bounds[chunk];
+    Line line;
+    while (nextLine(p, bounds[chunk + 1], comments, line)) {
+      offsets[chunk + 1]++;
+    }
+  });
+  for (std::size_t chunk = 1; chunk < offsets.size(); chunk++) {
+    offsets[chunk] += offsets[chunk - 1];
+  }
+  return offsets;
+}
+
+// the number at p after blanks and an optional plus sign, the position
+// after it or nullptr
+template <typename Number>
+const char* parseNumber(const char* p, const char* end, Number& value,
+                        char delimiter = 0) {
+  p = skipSpaces(p, end, delimiter);
+  if (p < end && *p == '+') p++;
+  auto result = std::from_chars(p, end, value);
+  return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+int checkedSize(long size) {
+  if (size < 0 || size > std::numeric_limits<int>::max()) {
+    throw std::invalid_argument("Incorrect input, the matrix is too large");
+  }
+  return static_cast<int>(size);
+}
+
+[[noreturn]] void malformed(const char* what, long line) {
+  throw std::invalid_argument(std::string("Incorrect input, malformed ") +
+                              what + " " + std::to_string(line + 1));
+}
+
+// row of cols fields into out
+void parseCsvRow(const Line& line, char delimiter, double* out, int cols,
+                 long row) {
+  const char* p = line.begin;
+  for (auto col = 0; col < cols; col++) {
+    if (col > 0) {
+      p = skipSpaces(p, line.end, delimiter);
+      if (p == line.end || *p != delimiter) malformed("CSV row", row);
+      p++;
+    }
+    p = parseNumber(p, line.end, out[col], delimiter);
+    if (!p) malformed("CSV row", row);
+  }
+  if (skipSpaces(p, line.end, delimiter) != line.end) {
+    malformed("CSV row", row);
+  }
+}
+
+enum class Symmetry { kGeneral, kSymmetric, kSkew };
+
+struct MatrixMarketHeader {
+  S21MatrixMarketFormat format;
+  bool pattern;
+  Symmetry symmetry;
+  long rows, cols, entries;
+};
+
+// the banner and the size line, p ends up at the first entry
+MatrixMarketHeader parseHeader(const char*& p, const char* end) {
+  if (p == end) {
+    throw std::invalid_argument("Incorrect input, not a Matrix Market file");
+  }
+  auto newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  std::string banner(p, newline ? newline : end);
+  p = newline ? newline + 1 : end;
+  std::transform(banner.begin(), banner.end(), banner.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  std::vector<std::string> words;
+  for (std::size_t start = 0; start < banner.size();) {
+    std::size_t stop = banner.find_first_of(" \t\r", start);
+    if (stop == std::string::npos) stop = banner.size();
+    if (stop > start) words.push_back(banner.substr(start, stop - start));
+    start = stop + 1;
+  }
+  if (words.size() != 5 || words[0] != "%%matrixmarket" ||
+      words[1] != "matrix") {
+    throw std::invalid_argument("Incorrect input, not a Matrix Market file");
+  }
+  MatrixMarketHeader header{};
+  if (words[2] == "array") {
+    header.format = S21MatrixMarketFormat::kArray;
+  } else if (words[2] == "coordinate") {
+    header.format = S21MatrixMarketFormat::kCoordinate;
+  } else {
+    throw std::invalid_argument(
+        "Incorrect input, unknown Matrix Market format");
+  }
+  header.pattern = words[3] == "pattern";
+  if (!(words[3] == "real" || words[3] == "integer" || words[3] == "double" ||
+        (header.pattern &&
+         header.format == S21MatrixMarketFormat::kCoordinate))) {
+    throw std::invalid_argument(
+        "Incorrect input, unsupported Matrix Market field");
+  }
+  if (words[4] == "general") {
+    header.symmetry = Symmetry::kGeneral;
+  } else if (words[4] == "symmetric") {
+    header.symmetry = Symmetry::kSymmetric;
+  } else if (words[4] == "skew-symmetric") {
+    header.symmetry = Symmetry::kSkew;
+  } else {
+    throw std::invalid_argument(
+        "Incorrect input, unsupported Matrix Market symmetry");
+  }
+
+  Line line;
+  if (!nextLine(p, end, true, line)) {
+    throw std::invalid_argument("Incorrect input, no Matrix Market size line");
+  }
+  const char* q = parseNumber(line.begin, line.end, header.rows);
+  if (q) q = parseNumber(q, line.end, header.cols);
+  if (q && header.format == S21MatrixMarketFormat::kCoordinate) {
+    q = parseNumber(q, line.end, header.entries);
+  }
+  if (!q || skipSpaces(q, line.end) != line.end || header.rows < 0 ||
+      header.cols < 0 || header.entries < 0) {
+    throw std::invalid_argument("Incorrect input, malformed size line");
+  }
+  if (header.symmetry != Symmetry::kGeneral && header.rows != header.cols) {
+    throw std::invalid_argument("The matrix is not square.");
+  }
+  // int sizes keep the entry counts below from overflowing a long
+  checkedSize(header.rows);
+  checkedSize(header.cols);
+  if (header.format == S21MatrixMarketFormat::kArray) {
+    // symmetric arrays keep the lower triangle, skew ones without diagonal
+    long n = header.rows;
+    header.entries = header.symmetry == Symmetry::kGeneral ? n * header.cols
+                     : header.symmetry == Symmetry::kSymmetric
+                         ? n * (n + 1) / 2
+                         : n * (n - 1) / 2;
+  }
+  return header;
+}
+
+// appends value in the shortest form that reads back exactly
+template <typename Number>
+void appendNumber(std::string& text, Number value) {
+  char buffer[32];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  text.append(buffer, result.ptr);
+}
+
+// lines formatted in parallel, piece k holding the lines from
+// BlockBegin(lines, parts, k) on
+std::vector<std::string> formatLines(
+    long lines, long elements,
+    const std::function<void(long, long, std::string&)>& format) {
+  const long parts =
+      std::max(1L, std::min(lines, elements * 24 / kChunkBytes + 1));
+  std::vector<std::string> pieces(parts);
+  forEachChunk(parts, [&](long part) {
+    format(S21ThreadPool::BlockBegin(lines, parts, part),
+           S21ThreadPool::BlockBegin(lines, parts, part + 1), pieces[part]);
+  });
+  return pieces;
+}
+
+void writeFile(const std::string& path, const std::string& header,
+               const std::vector<std::string>& pieces) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file) throw std::runtime_error("Cannot open " + path);
+  bool written =
+      std::fwrite(header.data(), 1, header.size(), file) == header.size();
+  for (const auto& piece : pieces) {
+    written = written && std::fwrite(piece.data(), 1, piece.size(), file) ==
+                             piece.size();
+  }
+  written = std::fclose(file) == 0 && written;
+  if (!written) throw std::runtime_error("Cannot write " + path);
+}
+}  // namespace
+
+S21Matrix S21Matrix::FromCSV(const std::string& path, char delimiter) {
+  MappedFile file(path);
+  std::vector<const char*> bounds = splitLines(file.begin(), file.end());
+  std::vector<long> offsets = lineOffsets(bounds, false);
+  // the first row fixes the number of columns
+  const char* p = file.begin();
+  Line first;
+  long fields = 0;
+  if (nextLine(p, file.end(), false, first)) {
+    fields = std::count(first.begin, first.end, delimiter) + 1;
+  }
+  S21Matrix result(checkedSize(offsets.back()), checkedSize(fields),
+                   uninitialized);
+  double* elements = result.matrix_;
+  const long stride = result.GetStride();
+  forEachChunk(bounds.size() - 1, [&](long chunk) {
+    const char* q = bounds[chunk];
+    Line line;
+    for (auto row = offsets[chunk];
+         nextLine(q, bounds[chunk + 1], false, line); row++) {
+      parseCsvRow(line, delimiter, elements + row * stride, result.cols_,
+                  row);
+    }
+  });
+  return result;
+}
+
+S21Matrix S21Matrix::FromMatrixMarket(const std::string& path) {
+  MappedFile file(path);
+  const char* body = file.begin();
+  const MatrixMarketHeader header = parseHeader(body, file.end());
+  std::vector<const char*> bounds = splitLines(body, file.end());
+  std::vector<long> offsets = lineOffsets(bounds, true);
+  if (offsets.back() != header.entries) {
+    throw std::invalid_argument(
+        "Incorrect input, the file has " + std::to_string(offsets.back()) +
+        " entries instead of " + std::to_string(header.entries));
+  }
+  const int rows = static_cast<int>(header.rows);
+  const int cols = static_cast<int>(header.cols);
+  const bool dense = header.format == S21MatrixMarketFormat::kArray &&
+                     header.symmetry == Symmetry::kGeneral;
+  S21Matrix result;
+  result.rows_ = rows;
+  result.cols_ = cols;
+  // a general array lists every element in column-major order, so it is
+  // parsed into column-major storage as is; the rest starts from zeros
+  result.createMatrix(!dense,
+                      dense ? S21Layout::kColMajor : S21Layout::kRowMajor);
+  double* elements = result.matrix_;
+  const long stride = result.GetStride();
+  const double sign = header.symmetry == Symmetry::kSkew ? -1.0 : 1.0;
+  // element (i, j) and its mirror for symmetric matrices
+  auto store = [&](long i, long j, double value) {
+    elements[i * stride + j] = value;
+    if (header.symmetry != Symmetry::kGeneral && i != j) {
+      elements[j * stride + i] = sign * value;
+    }
+  };
+
+  forEachChunk(bounds.size() - 1, [&](long chunk) {
+    const char* p = bounds[chunk];
+    long entry = offsets[chunk];
+    Line line;
+    if (header.format == S21MatrixMarketFormat::kCoordinate) {
+      for (; nextLine(p, bounds[chunk + 1], true, line); entry++) {
+        long i = 0, j = 0;
+        double value = 1.0;
+        const char* q = parseNumber(line.begin, line.end, i);
+        if (q) q = parseNumber(q, line.end, j);
+        if (q && !header.pattern) q = parseNumber(q, line.end, value);
+        if (!q || skipSpaces(q, line.end) != line.end) {
+          malformed("Matrix Market entry", entry);
+        }
+        if (i < 1 || i > rows || j < 1 || j > cols) {
+          throw std::invalid_argument(
+              "Incorrect input, Matrix Market entry " +
+              std::to_string(entry + 1) + " is outside the matrix");
+        }
+        store(i - 1, j - 1, value);
+      }
+      return;
+    }
+    // row and column of the first entry of the chunk; column col lists the
+    // rows from col + skip on, skew matrices leaving out the zero diagonal
+    const long skip = header.symmetry == Symmetry::kSkew ? 1 : 0;
+    long col = 0, row = entry;
+    if (!dense) {
+      while (col < cols && row >= rows - col - skip) {
+        row -= rows - col - skip;
+        col++;
+      }
+      row += col + skip;
+    }
+    for (; nextLine(p, bounds[chunk + 1], true, line); entry++) {
+      double value = 0.0;
+      const char* q = parseNumber(line.begin, line.end, value);
+      if (!q || skipSpaces(q, line.end) != line.end) {
+        malformed("Matrix Market entry", entry);
+      }
+      if (dense) {
+        elements[entry / rows * stride + entry % rows] = value;
+        continue;
+      }
+      store(row, col, value);
+      if (++row == rows) {
+        col++;
+        row = col + skip;
+      }
+    }
+  });
+  return result;
+}
+
+void S21Matrix::ToCSV(const std::string& path, char delimiter) const {
+  std::vector<std::string> pieces = formatLines(
+      rows_, static_cast<long>(rows_) * cols_,
+      [&](long begin, long end, std::string& text) {
+        for (auto i = begin; i < end; i++) {
+          for (auto j = 0; j < cols_; j++) {
+            if (j > 0) text += delimiter;
+            appendNumber(text, (*this)(i, j));
+          }
+          text += '\n';
+        }
+      });
+  writeFile(path, "", pieces);
+}
+
+void S21Matrix::ToMatrixMarket(const std::string& path,
+                               S21MatrixMarketFormat format) const {
+  std::string header = "%%MatrixMarket matrix ";
+  const long elements = static_cast<long>(rows_) * cols_;
+  if (format == S21MatrixMarketFormat::kArray) {
+    header += "array real general\n";
+    appendNumber(header, rows_);
+    header += ' ';
+    appendNumber(header, cols_);
+    header += '\n';
+    writeFile(path, header,
+              formatLines(cols_, elements,
+                          [&](long begin, long end, std::string& text) {
+                            for (auto j = begin; j < end; j++) {
+                              for (auto i = 0; i < rows_; i++) {
+                                appendNumber(text, (*this)(i, j));
+                                text += '\n';
+                              }
+                            }
+                          }));
+    return;
+  }
+  std::vector<std::string> pieces = formatLines(
+      rows_, elements, [&](long begin, long end, std::string& text) {
+        for (auto i = begin; i < end; i++) {
+          for (auto j = 0; j < cols_; j++) {
+            double value = (*this)(i, j);
+            if (value == 0.0) continue;
+            appendNumber(text, i + 1);
+            text += ' ';
+            appendNumber(text, j + 1);
+            text += ' ';
+            appendNumber(text, value);
+            text += '\n';
+          }
+        }
+      });
+  // one line per nonzero
+  long entries = 0;
+  for (const auto& piece : pieces) {
+    entries += std::count(piece.begin(), piece.end(), '\n');
+  }
+  header += "coordinate real general\n";
+  appendNumber(header, rows_);
+  header += ' ';
+  appendNumber(header, cols_);
+  header += ' ';
+  appendNumber(header, entries);
+  header += '\n';
+  writeFile(path, header, pieces);
+}
@@ -0,0 +1,396 @@
+#include "s21_matrix/s21_lowrank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+// a column keeping less than this part of its norm through the projections
+// lies in the span of the columns before it
+constexpr double kDependent = 1e-10;
+constexpr int kSweeps = 60;
+
+// cols columns of a column-major buffer, as a view
+S21MatrixView columnsOf(double* data, int rows, int cols, int stride) {
+  return S21Matrix::Wrap(data, rows, cols, S21Layout::kColMajor, stride);
+}
+
+double norm(const double* x, int length) {
+  double sum = 0.0;
+  for (auto i = 0; i < length; i++) sum += x[i] * x[i];
+  return std::sqrt(sum);
+}
+
+// orthonormal basis of the range of y, column-major: classical Gram-Schmidt
+// run twice for every column, each pass two matrix products with the
+// columns before it; dependent columns become zero
+S21Matrix orthonormalize(const S21Matrix& y) {
+  S21Matrix q = y.ToLayout(S21Layout::kColMajor);
+  const int rows = q.GetRows();
+  const int cols = q.GetCols();
+  if (rows == 0 || cols == 0) return q;
+  double* data = q.data();
+  const int stride = q.GetStride();
+  for (auto j = 0; j < cols; j++) {
+    double* column = data + static_cast<long>(j) * stride;
+    const double before = norm(column, rows);
+    S21MatrixView current = columnsOf(column, rows, 1, stride);
+    for (auto pass = 0; pass < 2 && j > 0; pass++) {
+      // the columns before j read as the rows of their transpose
+      S21Matrix projection =
+          S21Matrix::Wrap(data, j, rows, S21Layout::kRowMajor, stride) *
+          current;
+      current -= columnsOf(data, rows, j, stride) * projection;
+    }
+    const double after = norm(column, rows);
+    const double scale = after > kDependent * before ? 1.0 / after : 0.0;
+    for (auto i = 0; i < rows; i++) column[i] *= scale;
+  }
+  return q;
+}
+
+void rotate(double* x, double* y, int length, double c, double s) {
+  for (auto i = 0; i < length; i++) {
+    double p = x[i];
+    double q = y[i];
+    x[i] = c * p - s * q;
+    y[i] = s * p + c * q;
+  }
+}
+
+// one-sided Jacobi (Hestenes): plane rotations of pairs of columns of the
+// column-major w, in sweeps until every pair is orthogonal to working
+// precision, applied to the columns of rotations as well
+void orthogonalizeColumns(S21Matrix& w, S21Matrix& rotations) {
+  const int rows = w.GetRows();
+  const int cols = w.GetCols();
+  if (rows == 0 || cols == 0) return;
+  double* a = w.data();
+  const long stride = w.GetStride();
+  double* r = rotations.data();
+  const long r_stride = rotations.GetStride();
+  const double tolerance = rows * std::numeric_limits<double>::epsilon();
+  for (auto sweep = 0; sweep < kSweeps; sweep++) {
+    bool rotated = false;
+    for (auto p = 0; p < cols; p++) {
+      for (auto q = p + 1; q < cols; q++) {
+        double* x = a + p * stride;
+        double* y = a + q * stride;
+        double alpha = 0.0, beta = 0.0, gamma = 0.0;
+        for (auto i = 0; i < rows; i++) {
+          alpha += x[i] * x[i];
+          beta += y[i] * y[i];
+          gamma += x[i] * y[i];
+        }
+        if (std::fabs(gamma) <= tolerance * std::sqrt(alpha * beta)) continue;
+        rotated = true;
+        // the smaller root of t^2 + 2 zeta t - 1 zeroes the new product
+        double zeta = (beta - alpha) / (2 * gamma);
+        double t = std::copysign(1.0, zeta) /
+                   (std::fabs(zeta) + std::sqrt(1 + zeta * zeta));
+        double c = 1 / std::sqrt(1 + t * t);
+        rotate(x, y, rows, c, c * t);
+        rotate(r + p * r_stride, r + q * r_stride, cols, c, c * t);
+      }
+    }
+    if (!rotated) break;
+  }
+}
+
+// unnormalized fast Walsh-Hadamard transform, the size a power of two
+void hadamard(std::vector<double>& x) {
+  const std::size_t size = x.size();
+  for (std::size_t half = 1; half < size; half *= 2) {
+    for (std::size_t start = 0; start < size; start += 2 * half) {
+      for (auto j = start; j < start + half; j++) {
+        double a = x[j];
+        double b = x[j + half];
+        x[j] = a + b;
+        x[j + half] = a - b;
+      }
+    }
+  }
+}
+
+int paddedSize(int input) {
+  int padded = 1;
+  while (padded < input) padded *= 2;
+  return padded;
+}
+
+void checkProduct(const S21Matrix& a, int rows) {
+  if (a.GetRows() != rows) {
+    throw std::logic_error(
+        "Incorrect input, the number of inputed rows must be equal to the "
+        "number of columns of the first matrix.");
+  }
+}
+}  // namespace
+
+// sketch
+
+S21Sketch::S21Sketch(int input, int size, S21SketchKind kind,
+                     std::uint64_t seed)
+    : input_(input), size_(size), kind_(kind) {
+  if (input < 0 || size < 1) {
+    throw std::invalid_argument(
+        "Incorrect input, sketch sizes must be positive");
+  }
+  if (kind == S21SketchKind::kGaussian) {
+    omega_ = S21Matrix::Random(input, size, seed,
+                               S21Matrix::Distribution::kNormal) *
+             (1 / std::sqrt(size));
+    return;
+  }
+  const int padded = paddedSize(input);
+  if (size > padded) {
+    throw std::invalid_argument(
+        "Incorrect input, the sketch is larger than the transform");
+  }
+  std::mt19937_64 random(seed);
+  signs_.resize(input);
+  for (auto& sign : signs_) sign = random() & 1 ? 1.0 : -1.0;
+  // the first size positions of a random permutation (Fisher-Yates)
+  std::vector<int> positions(padded);
+  std::iota(positions.begin(), positions.end(), 0);
+  for (auto k = 0; k < size; k++) {
+    std::swap(positions[k], positions[k + random() % (padded - k)]);
+  }
+  samples_.assign(positions.begin(), positions.begin() + size);
+}
+
+int S21Sketch::GetInput() const noexcept { return input_; }
+
+int S21Sketch::GetSize() const noexcept { return size_; }
+
+S21SketchKind S21Sketch::GetKind() const noexcept { return kind_; }
+
+S21Matrix S21Sketch::Apply(const S21Matrix& a) const {
+  if (a.GetCols() != input_) {
+    throw std::logic_error(
+        "Incorrect input, the matrix must have as many columns as the "
+        "sketch has inputs.");
+  }
+  if (kind_ == S21SketchKind::kGaussian) return a * omega_;
+  const int rows = a.GetRows();
+  const int padded = paddedSize(input_);
+  // the Hadamard matrix of the transform is scaled by 1 / sqrt(padded) and
+  // the sampling by sqrt(padded / size)
+  const double scale = 1 / std::sqrt(size_);
+  S21Matrix result(rows, size_, S21Matrix::uninitialized);
+  double* out = result.data();
+  const long stride = result.GetStride();
+  // a transform costs padded * log2(padded)
+  const long work_per_row = padded * std::max(1.0, std::log2(padded));
+  S21ThreadPool::ParallelRows(rows, work_per_row, [&](long begin, long end) {
+    std::vector<double> work(padded);
+    for (auto i = begin; i < end; i++) {
+      for (auto j = 0; j < input_; j++) {
+        work[j] = a(static_cast<int>(i), j) * signs_[j];
+      }
+      std::fill(work.begin() + input_, work.end(), 0.0);
+      hadamard(work);
+      for (auto k = 0; k < size_; k++) {
+        out[i * stride + k] = work[samples_[k]] * scale;
+      }
+    }
+  });
+  return result;
+}
+
+S21Matrix S21Sketch::ApplyLeft(const S21Matrix& a) const {
+  if (a.GetRows() != input_) {
+    throw std::logic_error(
+        "Incorrect input, the matrix must have as many rows as the sketch "
+        "has inputs.");
+  }
+  if (kind_ == S21SketchKind::kGaussian) return omega_.Transpose() * a;
+  return Apply(a.Transpose()).Transpose();
+}
+
+S21Matrix S21Sketch::ApproximateProduct(const S21Matrix& a,
+                                        const S21Matrix& b) const {
+  return Apply(a) * ApplyLeft(b);
+}
+
+// range finder
+
+S21Matrix S21Matrix::RangeFinder(int size,
+                                 const S21RandomizedOptions& options) const {
+  if (size < 1 || options.oversampling < 0 || options.power_iterations < 0) {
+    throw std::invalid_argument(
+        "Incorrect input, sizes and iterations must be positive");
+  }
+  size = std::min({size, rows_, cols_});
+  if (size == 0) return S21Matrix(rows_, 0);
+  S21Sketch sketch(cols_, size, options.sketch, options.seed);
+  S21Matrix q = orthonormalize(sketch.Apply(*this));
+  for (auto pass = 0; pass < options.power_iterations; pass++) {
+    q = orthonormalize(*this * orthonormalize(Transpose() * q));
+  }
+  return q;
+}
+
+// low-rank matrix
+
+S21LowRankMatrix::S21LowRankMatrix(const S21Matrix& left,
+                                   const S21Matrix& right) {
+  if (left.GetCols() != right.GetCols()) {
+    throw std::logic_error(
+        "Incorrect input, the factors must have the same number of columns.");
+  }
+  S21Matrix q = orthonormalize(left);
+  // (left * right^T)^T * q
+  *this = fromRange(q, right * (left.Transpose() * q));
+}
+
+S21LowRankMatrix S21LowRankMatrix::RandomizedSvd(
+    const S21Matrix& a, int rank, const S21RandomizedOptions& options) {
+  if (rank < 1) {
+    throw std::invalid_argument("Incorrect input, the rank must be positive");
+  }
+  S21Matrix q = a.RangeFinder(rank + options.oversampling, options);
+  S21LowRankMatrix result = fromRange(q, a.Transpose() * q);
+  result.Truncate(rank);
+  return result;
+}
+
+S21LowRankMatrix S21LowRankMatrix::fromRange(const S21Matrix& q,
+                                             const S21Matrix& w) {
+  // w = A^T * q = W * R^T with orthogonal columns in W after the rotations
+  // R, so that A = q * q^T * A = (q * R) * (W^T)
+  S21Matrix columns = w.ToLayout(S21Layout::kColMajor);
+  const int size = columns.GetCols();
+  const int cols = columns.GetRows();
+  S21Matrix rotations =
+      S21Matrix::Identity(size).ToLayout(S21Layout::kColMajor);
+  orthogonalizeColumns(columns, rotations);
+
+  const S21Matrix& rotated = columns;
+  std::vector<double> norms(size);
+  for (auto k = 0; k < size; k++) {
+    norms[k] =
+        norm(rotated.data() + static_cast<long>(k) * rotated.GetStride(), cols);
+  }
+  std::vector<int> order(size);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&norms](int a, int b) { return norms[a] > norms[b]; });
+  S21LowRankMatrix result;
+  result.s_.resize(size);
+  result.v_ = S21Matrix(cols, size);
+  S21Matrix sorted(size, size);
+  const S21Matrix& turns = rotations;
+  for (auto k = 0; k < size; k++) {
+    const int j = order[k];
+    const double sigma = norms[j];
+    result.s_[k] = sigma;
+    for (auto i = 0; i < cols; i++) {
+      result.v_(i, k) = sigma > 0.0 ? rotated(i, j) / sigma : 0.0;
+    }
+    for (auto i = 0; i < size; i++) sorted(i, k) = turns(i, j);
+  }
+  result.u_ = q * sorted;
+  return result;
+}
+
+int S21LowRankMatrix::GetRows() const noexcept { return u_.GetRows(); }
+
+int S21LowRankMatrix::GetCols() const noexcept { return v_.GetRows(); }
+
+int S21LowRankMatrix::GetRank() const noexcept {
+  return static_cast<int>(s_.size());
+}
+
+const S21Matrix& S21LowRankMatrix::GetU() const noexcept { return u_; }
+
+const std::vector<double>& S21LowRankMatrix::GetSingularValues()
+    const noexcept {
+  return s_;
+}
+
+const S21Matrix& S21LowRankMatrix::GetV() const noexcept { return v_; }
+
+S21Matrix S21LowRankMatrix::ToDense() const {
+  const S21Matrix& u = u_;
+  S21Matrix scaled = S21Matrix::FromGenerator(
+      u.GetRows(), GetRank(), [&](int i, int k) { return u(i, k) * s_[k]; });
+  return scaled * v_.Transpose();
+}
+
+S21LowRankMatrix S21LowRankMatrix::Transpose() const {
+  S21LowRankMatrix result;
+  result.u_ = v_;
+  result.v_ = u_;
+  result.s_ = s_;
+  return result;
+}
+
+void S21LowRankMatrix::Truncate(int rank) {
+  if (rank < 0) {
+    throw std::invalid_argument("Incorrect input, the rank is negative");
+  }
+  if (rank >= GetRank()) return;
+  const S21Matrix& u = u_;
+  const S21Matrix& v = v_;
+  S21Matrix left = S21Matrix::FromGenerator(
+      u.GetRows(), rank, [&u](int i, int k) { return u(i, k); });
+  S21Matrix right = S21Matrix::FromGenerator(
+      v.GetRows(), rank, [&v](int i, int k) { return v(i, k); });
+  u_ = std::move(left);
+  v_ = std::move(right);
+  s_.resize(rank);
+}
+
+double S21LowRankMatrix::FrobeniusNorm() const noexcept {
+  double sum = 0.0;
+  for (double sigma : s_) sum += sigma * sigma;
+  return std::sqrt(sum);
+}
+
+S21Matrix S21LowRankMatrix::Multiply(const S21Matrix& x) const {
+  checkProduct(x, GetCols());
+  const S21Matrix inner = v_.Transpose() * x;
+  return u_ * S21Matrix::FromGenerator(
+                  GetRank(), x.GetCols(),
+                  [&](int k, int j) { return s_[k] * inner(k, j); });
+}
+
+S21LowRankMatrix S21LowRankMatrix::Multiply(
+    const S21LowRankMatrix& other) const {
+  if (GetCols() != other.GetRows()) {
+    throw std::logic_error(
+        "Incorrect input, the number of inputed rows must be equal to the "
+        "number of columns of the first matrix.");
+  }
+  // U1 * (S1 * V1^T * U2 * S2) * V2^T
+  const S21Matrix inner = v_.Transpose() * other.u_;
+  S21Matrix middle = S21Matrix::FromGenerator(
+      GetRank(), other.GetRank(), [&](int i, int j) {
+        return s_[i] * inner(i, j) * other.s_[j];
+      });
+  S21LowRankMatrix result(u_ * middle, other.v_);
+  result.Truncate(std::min(GetRank(), other.GetRank()));
+  return result;
+}
+
+S21Matrix S21LowRankMatrix::Solve(const S21Matrix& rhs) const {
+  if (rhs.GetRows() != GetRows()) {
+    throw std::logic_error(
+        "Incorrect input, the right-hand side must have as many rows as the "
+        "matrix.");
+  }
+  const double epsilon = std::numeric_limits<double>::epsilon();
+  const double cutoff =
+      s_.empty() ? 0.0 : std::max(GetRows(), GetCols()) * epsilon * s_[0];
+  const S21Matrix inner = u_.Transpose() * rhs;
+  return v_ * S21Matrix::FromGenerator(
+                  GetRank(), rhs.GetCols(), [&](int k, int j) {
+                    return s_[k] > cutoff ? inner(k, j) / s_[k] : 0.0;
+                  });
+}
@@ -0,0 +1,90 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_LOWRANK_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_LOWRANK_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "s21_matrix/s21_matrix_oop.h"
+
+// random input x size map Omega with E[Omega * Omega^T] = I, so that
+// A * Omega keeps the row norms of A and (A * Omega) * (Omega^T * B)
+// estimates A * B
+class S21Sketch {
+ public:
+  // throws std::invalid_argument for a negative input, a size below 1 or,
+  // for SRHT, a size above input rounded up to a power of two
+  S21Sketch(int input, int size, S21SketchKind kind, std::uint64_t seed);
+
+  int GetInput() const noexcept;
+  int GetSize() const noexcept;
+  S21SketchKind GetKind() const noexcept;
+
+  // A * Omega for A with input columns: a product with the Gaussian matrix,
+  // O(rows * input * size), or a Walsh-Hadamard transform of every row,
+  // O(rows * input * log input)
+  S21Matrix Apply(const S21Matrix& a) const;
+  // Omega^T * A for A with input rows
+  S21Matrix ApplyLeft(const S21Matrix& a) const;
+  // (A * Omega) * (Omega^T * B), an unbiased estimate of A * B
+  S21Matrix ApproximateProduct(const S21Matrix& a, const S21Matrix& b) const;
+
+ private:
+  int input_, size_;
+  S21SketchKind kind_;
+  // Gaussian
+  S21Matrix omega_;
+  // SRHT: the sign of every input and the transformed positions kept
+  std::vector<double> signs_;
+  std::vector<int> samples_;
+};
+
+// rows x cols matrix of rank at most k kept as U * diag(s) * V^T, with
+// orthonormal columns in U (rows x k) and V (cols x k) and the singular
+// values s in decreasing order; products and solves cost O((rows + cols) *
+// k) per column instead of O(rows * cols)
+class S21LowRankMatrix {
+ public:
+  // left * right^T, throws std::logic_error unless both have the same
+  // number of columns; O((rows + cols) * k^2)
+  S21LowRankMatrix(const S21Matrix& left, const S21Matrix& right);
+  // truncated SVD of a through its RangeFinder with rank +
+  // options.oversampling columns, O(rows * cols * rank); throws
+  // std::invalid_argument for a rank below 1
+  static S21LowRankMatrix RandomizedSvd(
+      const S21Matrix& a, int rank,
+      const S21RandomizedOptions& options = S21RandomizedOptions());
+
+  int GetRows() const noexcept;
+  int GetCols() const noexcept;
+  int GetRank() const noexcept;
+  const S21Matrix& GetU() const noexcept;
+  const std::vector<double>& GetSingularValues() const noexcept;
+  const S21Matrix& GetV() const noexcept;
+
+  // the dense matrix, O(rows * cols * k)
+  S21Matrix ToDense() const;
+  S21LowRankMatrix Transpose() const;
+  // keeps the rank largest singular values
+  void Truncate(int rank);
+  double FrobeniusNorm() const noexcept;
+
+  // this * x
+  S21Matrix Multiply(const S21Matrix& x) const;
+  // this * other, of rank at most the smaller of the two
+  S21LowRankMatrix Multiply(const S21LowRankMatrix& other) const;
+  // minimum norm least squares solution of this * X = rhs through the
+  // pseudo-inverse, singular values up to max(rows, cols) * eps times the
+  // largest count as zero
+  S21Matrix Solve(const S21Matrix& rhs) const;
+
+ private:
+  S21LowRankMatrix() = default;
+  // the factorization of A from q with orthonormal columns spanning the
+  // range of A and w = A^T * q
+  static S21LowRankMatrix fromRange(const S21Matrix& q, const S21Matrix& w);
+
+  S21Matrix u_, v_;
+  std::vector<double> s_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_LOWRANK_H_
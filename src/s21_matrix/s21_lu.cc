@@ -0,0 +1,358 @@
+#include "s21_matrix/s21_lu.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+// interchanges rows r and swaps[r] for r in [first, last) within columns
+// [begin, end) of the row-major n x n matrix a
+void swapRows(double* a, long n, const std::vector<int>& swaps, int first,
+              int last, int begin, int end) {
+  for (auto r = first; r < last; r++) {
+    if (swaps[r] != r) {
+      std::swap_ranges(a + r * n + begin, a + r * n + end,
+                       a + swaps[r] * n + begin);
+    }
+  }
+}
+
+// largest absolute column sum of the row-major n x n matrix a
+double norm1(const double* a, long n) {
+  std::vector<double> sums(n);
+  for (auto i = 0L; i < n; i++) {
+    for (auto j = 0L; j < n; j++) sums[j] += std::fabs(a[i * n + j]);
+  }
+  return n > 0 ? *std::max_element(sums.begin(), sums.end()) : 0.0;
+}
+
+// row-major copy of matrix to factor in place, rejecting a non-square one
+// before anything is copied
+S21Matrix squareRowMajor(const S21Matrix& matrix) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  return matrix.ToLayout(S21Layout::kRowMajor);
+}
+}  // namespace
+
+S21LU::S21LU(const S21Matrix& matrix) : S21LU(matrix, S21TaskControl()) {}
+
+S21LU::S21LU(const S21Matrix& matrix, const S21TaskControl& control)
+    : lu_(squareRowMajor(matrix)),
+      pivots_(matrix.GetRows()),
+      sign_(1),
+      singular_(false),
+      norm1_(0.0) {
+  const int n = lu_.GetRows();
+  double* a = lu_.data();
+  norm1_ = norm1(a, n);
+  for (auto i = 0; i < n; i++) pivots_[i] = i;
+
+  for (auto k = 0; k < n; k++) {
+    // the remaining work shrinks with the cube of the trailing size
+    double rest = static_cast<double>(n - k) / n;
+    control.Checkpoint(1.0 - rest * rest * rest);
+    int pivot = k;
+    for (auto i = k + 1; i < n; i++) {
+      if (std::fabs(a[i * n + k]) > std::fabs(a[pivot * n + k])) pivot = i;
+    }
+    if (a[pivot * n + k] == 0.0) {
+      singular_ = true;
+      continue;
+    }
+    if (pivot != k) {
+      std::swap_ranges(a + k * n, a + (k + 1) * n, a + pivot * n);
+      std::swap(pivots_[k], pivots_[pivot]);
+      sign_ = -sign_;
+    }
+    const double* pivot_row = a + k * n;
+    S21ThreadPool::ParallelRows(n - k - 1, n - k, [&](long begin, long end) {
+      for (auto i = k + 1 + begin; i < k + 1 + end; i++) {
+        double* row = a + i * n;
+        double factor = row[k] /= pivot_row[k];
+        for (auto j = k + 1; j < n; j++) row[j] -= factor * pivot_row[j];
+      }
+    });
+  }
+}
+
+S21LU::S21LU(const S21Matrix& matrix, int tile, S21Schedule schedule)
+    : lu_(squareRowMajor(matrix)),
+      pivots_(matrix.GetRows()),
+      sign_(1),
+      singular_(false),
+      norm1_(0.0) {
+  if (tile < 1) throw std::invalid_argument("Tile size must be positive");
+  const int n = lu_.GetRows();
+  const int tiles = (n + tile - 1) / tile;
+  double* a = lu_.data();
+  norm1_ = norm1(a, n);
+  // swaps[r]: the row interchanged with row r at elimination step r
+  std::vector<int> swaps(n);
+  auto key = [tiles](int i, int j) { return static_cast<long>(i) * tiles + j; };
+  auto pivot_key = [tiles](int k) {
+    return static_cast<long>(tiles) * tiles + k;
+  };
+  auto column = [&](int first, int from) {
+    std::vector<long> keys;
+    for (auto i = from; i < tiles; i++) keys.push_back(key(i, first));
+    return keys;
+  };
+
+  S21TileGraph graph(schedule);
+  for (auto k = 0; k < tiles; k++) {
+    const int c0 = k * tile;
+    const int c1 = std::min(n, c0 + tile);
+    // the panel below and on the diagonal, the critical path
+    std::vector<long> panel = column(k, k);
+    panel.push_back(pivot_key(k));
+    graph.AddTask(
+        [=, &swaps] {
+          for (auto c = c0; c < c1; c++) {
+            int pivot = c;
+            for (auto i = c + 1; i < n; i++) {
+              if (std::fabs(a[i * n + c]) > std::fabs(a[pivot * n + c])) {
+                pivot = i;
+              }
+            }
+            swaps[c] = pivot;
+            if (a[pivot * n + c] == 0.0) {
+              singular_ = true;
+              continue;
+            }
+            if (pivot != c) {
+              std::swap_ranges(a + c * n + c0, a + c * n + c1,
+                               a + pivot * n + c0);
+            }
+            for (auto i = c + 1; i < n; i++) {
+              double* row = a + i * n;
+              double factor = row[c] /= a[c * n + c];
+              for (auto j = c + 1; j < c1; j++) row[j] -= factor * a[c * n + j];
+            }
+          }
+        },
+        {}, panel, 2 * (tiles - k) + 1);
+    graph.Barrier();
+
+    for (auto j = 0; j < tiles; j++) {
+      if (j == k) continue;
+      const int j0 = j * tile;
+      const int j1 = std::min(n, j0 + tile);
+      if (j < k) {
+        // the factored columns on the left only need the interchanges
+        graph.AddTask([=, &swaps] { swapRows(a, n, swaps, c0, c1, j0, j1); },
+                      {pivot_key(k)}, column(j, k));
+        continue;
+      }
+      // interchanges, then U(k, j) = L(k, k)^-1 A(k, j)
+      graph.AddTask(
+          [=, &swaps] {
+            swapRows(a, n, swaps, c0, c1, j0, j1);
+            for (auto r = c0; r < c1; r++) {
+              for (auto q = c0; q < r; q++) {
+                double factor = a[r * n + q];
+                for (auto c = j0; c < j1; c++) {
+                  a[r * n + c] -= factor * a[q * n + c];
+                }
+              }
+            }
+          },
+          {pivot_key(k), key(k, k)}, column(j, k), 2 * (tiles - j));
+    }
+    graph.Barrier();
+
+    for (auto j = k + 1; j < tiles; j++) {
+      const int j0 = j * tile;
+      const int j1 = std::min(n, j0 + tile);
+      for (auto i = k + 1; i < tiles; i++) {
+        const int i0 = i * tile;
+        const int i1 = std::min(n, i0 + tile);
+        // A(i, j) -= L(i, k) * U(k, j)
+        graph.AddTask(
+            [=] {
+              for (auto r = i0; r < i1; r++) {
+                for (auto q = c0; q < c1; q++) {
+                  double factor = a[r * n + q];
+                  for (auto c = j0; c < j1; c++) {
+                    a[r * n + c] -= factor * a[q * n + c];
+                  }
+                }
+              }
+            },
+            {key(i, k), key(k, j)}, {key(i, j)}, 2 * (tiles - j));
+      }
+    }
+    graph.Barrier();
+  }
+  graph.Run();
+
+  for (auto i = 0; i < n; i++) pivots_[i] = i;
+  for (auto r = 0; r < n; r++) {
+    if (swaps[r] != r) {
+      std::swap(pivots_[r], pivots_[swaps[r]]);
+      sign_ = -sign_;
+    }
+  }
+}
+
+int S21LU::GetSize() const noexcept { return lu_.GetRows(); }
+
+const S21Matrix& S21LU::GetFactors() const noexcept { return lu_; }
+
+const std::vector<int>& S21LU::GetPivots() const noexcept { return pivots_; }
+
+bool S21LU::IsSingular() const noexcept { return singular_; }
+
+double S21LU::Determinant() const noexcept {
+  if (singular_) return 0.0;
+  const int n = GetSize();
+  const double* a = lu_.data();
+  double result = sign_;
+  for (auto i = 0; i < n; i++) result *= a[i * n + i];
+  return result;
+}
+
+double S21LU::Norm1() const noexcept { return norm1_; }
+
+double S21LU::InverseNorm1Estimate() const {
+  if (singular_) return std::numeric_limits<double>::infinity();
+  const int n = GetSize();
+  if (n == 0) return 0.0;
+  auto norm = [](const S21Matrix& v) {
+    double sum = 0.0;
+    for (auto i = 0; i < v.GetRows(); i++) sum += std::fabs(v(i, 0));
+    return sum;
+  };
+  auto sign = [](double x) { return x >= 0.0 ? 1.0 : -1.0; };
+  // A^-T xi as a column, through xi^T A^-1 = z with z A = xi^T
+  auto transposed = [this, n](const S21Matrix& xi) {
+    S21Matrix row(1, n, S21Matrix::uninitialized);
+    for (auto i = 0; i < n; i++) row(0, i) = xi(i, 0);
+    S21Matrix z = SolveTransposed(row);
+    S21Matrix column(n, 1, S21Matrix::uninitialized);
+    for (auto i = 0; i < n; i++) column(i, 0) = z(0, i);
+    return column;
+  };
+  auto largest = [n](const S21Matrix& z) {
+    int index = 0;
+    for (auto i = 1; i < n; i++) {
+      if (std::fabs(z(i, 0)) > std::fabs(z(index, 0))) index = i;
+    }
+    return index;
+  };
+
+  S21Matrix x(n, 1);
+  x.Fill(1.0 / n);
+  S21Matrix y = Solve(x);
+  double estimate = norm(y);
+  if (n > 1) {
+    // climbs the convex function ||A^-1 x||_1 over the unit ball from
+    // vertex to vertex, a few steps are enough in practice
+    S21Matrix xi(n, 1, S21Matrix::uninitialized);
+    for (auto i = 0; i < n; i++) xi(i, 0) = sign(y(i, 0));
+    int j = largest(transposed(xi));
+    for (auto step = 0; step < 4; step++) {
+      S21Matrix unit(n, 1);
+      unit(j, 0) = 1.0;
+      y = Solve(unit);
+      double previous = estimate;
+      estimate = norm(y);
+      bool repeated = true;
+      for (auto i = 0; i < n; i++) {
+        repeated = repeated && sign(y(i, 0)) == xi(i, 0);
+      }
+      if (repeated || estimate <= previous) break;
+      for (auto i = 0; i < n; i++) xi(i, 0) = sign(y(i, 0));
+      S21Matrix z = transposed(xi);
+      int last = j;
+      j = largest(z);
+      if (std::fabs(z(last, 0)) == std::fabs(z(j, 0))) break;
+    }
+    // Higham's alternating vector guards against the cases the climb misses
+    for (auto i = 0; i < n; i++) {
+      x(i, 0) = (i % 2 ? -1.0 : 1.0) * (1.0 + static_cast<double>(i) / (n - 1));
+    }
+    estimate = std::max(estimate, 2.0 * norm(Solve(x)) / (3.0 * n));
+  }
+  return estimate;
+}
+
+double S21LU::Rcond() const {
+  if (singular_) return 0.0;
+  if (GetSize() == 0) return 1.0;
+  double inverse = InverseNorm1Estimate();
+  if (norm1_ == 0.0 || !std::isfinite(inverse)) return 0.0;
+  return 1.0 / (norm1_ * inverse);
+}
+
+bool S21LU::IsSingular(double tolerance) const {
+  return Rcond() < tolerance;
+}
+
+S21Matrix S21LU::Solve(const S21Matrix& rhs) const {
+  const int n = GetSize();
+  if (rhs.GetRows() != n) {
+    throw std::logic_error(
+        "Incorrect input, the right-hand side must have as many rows as the "
+        "matrix.");
+  }
+  if (singular_) throw std::logic_error("The matrix is singular.");
+  const int m = rhs.GetCols();
+  const double* a = lu_.data();
+  S21Matrix result(n, m, S21Matrix::uninitialized);
+  double* x = result.data();
+  for (auto i = 0; i < n; i++) {
+    for (auto j = 0; j < m; j++) x[i * m + j] = rhs(pivots_[i], j);
+  }
+  // L * Y = P * rhs, then U * X = Y, both row by row
+  for (auto i = 0; i < n; i++) {
+    for (auto k = 0; k < i; k++) {
+      double factor = a[i * n + k];
+      for (auto j = 0; j < m; j++) x[i * m + j] -= factor * x[k * m + j];
+    }
+  }
+  for (auto i = n - 1; i >= 0; i--) {
+    for (auto k = i + 1; k < n; k++) {
+      double factor = a[i * n + k];
+      for (auto j = 0; j < m; j++) x[i * m + j] -= factor * x[k * m + j];
+    }
+    for (auto j = 0; j < m; j++) x[i * m + j] /= a[i * n + i];
+  }
+  return result;
+}
+
+S21Matrix S21LU::SolveTransposed(const S21Matrix& rhs) const {
+  const int n = GetSize();
+  if (rhs.GetCols() != n) {
+    throw std::logic_error(
+        "Incorrect input, the right-hand side must have as many columns as "
+        "the matrix.");
+  }
+  if (singular_) throw std::logic_error("The matrix is singular.");
+  const int m = rhs.GetRows();
+  const double* a = lu_.data();
+  S21Matrix result(m, n, S21Matrix::uninitialized);
+  double* x = result.data();
+  std::vector<double> t(n);
+  for (auto r = 0; r < m; r++) {
+    // X = rhs * A^-1 = rhs * U^-1 * L^-1 * P, one row of rhs at a time
+    for (auto j = 0; j < n; j++) t[j] = rhs(r, j);
+    for (auto j = 0; j < n; j++) {
+      t[j] /= a[j * n + j];
+      for (auto l = j + 1; l < n; l++) t[l] -= t[j] * a[j * n + l];
+    }
+    for (auto j = n - 1; j >= 0; j--) {
+      for (auto l = 0; l < j; l++) t[l] -= t[j] * a[j * n + l];
+    }
+    for (auto j = 0; j < n; j++) x[r * n + pivots_[j]] = t[j];
+  }
+  return result;
+}
+
+S21Matrix S21LU::Inverse() const {
+  return Solve(S21Matrix::Identity(GetSize()));
+}
@@ -0,0 +1,59 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_LU_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_LU_H_
+
+#include <vector>
+
+#include "s21_matrix/s21_matrix_oop.h"
+#include "s21_matrix/s21_tile_graph.h"
+
+// LU factorization with partial pivoting, P * A = L * U
+class S21LU {
+ public:
+  // throws std::logic_error for a non-square matrix
+  explicit S21LU(const S21Matrix& matrix);
+  // checkpoints control before every elimination step
+  S21LU(const S21Matrix& matrix, const S21TaskControl& control);
+  // tiled right-looking LU on a task graph: the panel factorization of each
+  // tile column, the row interchanges with the triangular solves of a tile
+  // row, and the tile updates of the trailing matrix are separate tasks;
+  // same factors and pivots as the unblocked version
+  S21LU(const S21Matrix& matrix, int tile,
+        S21Schedule schedule = S21Schedule::kDataflow);
+
+  int GetSize() const noexcept;
+  // L below the diagonal (its unit diagonal is implied) and U on and above
+  // it, row-major
+  const S21Matrix& GetFactors() const noexcept;
+  // row i of L * U is row GetPivots()[i] of the factorized matrix
+  const std::vector<int>& GetPivots() const noexcept;
+  // whether elimination met an exactly zero pivot column
+  bool IsSingular() const noexcept;
+
+  double Determinant() const noexcept;
+  // ||A||_1 of the factorized matrix
+  double Norm1() const noexcept;
+  // estimate of ||A^-1||_1 by Hager's method as refined by Higham (LAPACK
+  // xLACN2): a handful of solves with A and A^T, O(n^2) on top of the
+  // factors; a lower bound, rarely off by more than a factor of 3
+  double InverseNorm1Estimate() const;
+  // reciprocal condition number 1 / (||A||_1 ||A^-1||_1) from the estimate,
+  // 0 for a singular matrix and 1 at best; it does not change when A is
+  // scaled, unlike the determinant
+  double Rcond() const;
+  // whether Rcond() is below tolerance, machine epsilon being the usual one
+  bool IsSingular(double tolerance) const;
+  // X with A * X = rhs, throws std::logic_error if A is singular
+  S21Matrix Solve(const S21Matrix& rhs) const;
+  // X with X * A = rhs
+  S21Matrix SolveTransposed(const S21Matrix& rhs) const;
+  S21Matrix Inverse() const;
+
+ private:
+  S21Matrix lu_;
+  std::vector<int> pivots_;
+  int sign_;
+  bool singular_;
+  double norm1_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_LU_H_
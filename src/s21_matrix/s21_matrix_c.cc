@@ -0,0 +1,153 @@
+#include "s21_matrix/s21_matrix_c.h"
+
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include "s21_matrix/s21_matrix_oop.h"
+
+struct s21_matrix {
+  explicit s21_matrix(S21Matrix&& matrix)
+      : owned(std::move(matrix)), value(owned) {}
+  explicit s21_matrix(std::unique_ptr<S21MatrixView> borrowed)
+      : view(std::move(borrowed)), value(*view) {}
+
+  S21Matrix owned;
+  // set for s21_matrix_wrap, value then refers to it
+  std::unique_ptr<S21MatrixView> view;
+  S21Matrix& value;
+};
+
+namespace {
+S21Layout toLayout(s21_layout layout) {
+  return layout == S21_COL_MAJOR ? S21Layout::kColMajor
+                                 : S21Layout::kRowMajor;
+}
+
+// runs body and turns the exceptions of S21Matrix into status codes
+template <class Body>
+s21_status guarded(Body body) {
+  try {
+    body();
+  } catch (const std::invalid_argument&) {
+    return S21_INVALID_ARGUMENT;
+  } catch (const std::out_of_range&) {
+    return S21_OUT_OF_RANGE;
+  } catch (const std::logic_error&) {
+    return S21_CALCULATION_ERROR;
+  } catch (const std::bad_alloc&) {
+    return S21_NO_MEMORY;
+  } catch (...) {
+    return S21_CALCULATION_ERROR;
+  }
+  return S21_OK;
+}
+
+s21_status wrapResult(S21Matrix&& value, s21_matrix** result) {
+  return guarded([&] { *result = new s21_matrix{std::move(value)}; });
+}
+}  // namespace
+
+s21_status s21_matrix_create(int rows, int cols, s21_matrix** result) {
+  if (!result) return S21_INVALID_ARGUMENT;
+  return guarded([&] { *result = new s21_matrix{S21Matrix(rows, cols)}; });
+}
+
+s21_status s21_matrix_wrap(double* data, int rows, int cols, s21_layout layout,
+                           int stride, s21_matrix** result) {
+  if (!result) return S21_INVALID_ARGUMENT;
+  return guarded([&] {
+    std::unique_ptr<S21MatrixView> view(new S21MatrixView(
+        S21Matrix::Wrap(data, rows, cols, toLayout(layout), stride)));
+    *result = new s21_matrix{std::move(view)};
+  });
+}
+
+s21_status s21_matrix_adopt(double* data, int rows, int cols,
+                            s21_layout layout, int stride,
+                            void (*release)(void* context), void* context,
+                            s21_matrix** result) {
+  if (!result || !release) return S21_INVALID_ARGUMENT;
+  std::shared_ptr<double[]> owner;
+  s21_status status = guarded([&] {
+    owner = std::shared_ptr<double[]>(
+        data, [release, context](double*) { release(context); });
+  });
+  if (status != S21_OK) return status;
+  return guarded([&] {
+    *result = new s21_matrix{S21Matrix(std::move(owner), rows, cols,
+                                       toLayout(layout), stride)};
+  });
+}
+
+void s21_matrix_destroy(s21_matrix* matrix) { delete matrix; }
+
+int s21_matrix_rows(const s21_matrix* matrix) {
+  return matrix->value.GetRows();
+}
+
+int s21_matrix_cols(const s21_matrix* matrix) {
+  return matrix->value.GetCols();
+}
+
+s21_layout s21_matrix_layout(const s21_matrix* matrix) {
+  return matrix->value.GetLayout() == S21Layout::kColMajor ? S21_COL_MAJOR
+                                                           : S21_ROW_MAJOR;
+}
+
+int s21_matrix_stride(const s21_matrix* matrix) {
+  return matrix->value.GetStride();
+}
+
+double* s21_matrix_data(s21_matrix* matrix) {
+  double* data = nullptr;
+  guarded([&] { data = matrix->value.data(); });
+  return data;
+}
+
+s21_status s21_matrix_sum(const s21_matrix* a, const s21_matrix* b,
+                          s21_matrix** result) {
+  if (!a || !b || !result) return S21_INVALID_ARGUMENT;
+  if (a->value.GetRows() != b->value.GetRows() ||
+      a->value.GetCols() != b->value.GetCols()) {
+    return S21_SIZE_MISMATCH;
+  }
+  S21Matrix value;
+  s21_status status = guarded([&] { value = a->value + b->value; });
+  return status == S21_OK ? wrapResult(std::move(value), result) : status;
+}
+
+s21_status s21_matrix_mul(const s21_matrix* a, const s21_matrix* b,
+                          s21_matrix** result) {
+  if (!a || !b || !result) return S21_INVALID_ARGUMENT;
+  if (a->value.GetCols() != b->value.GetRows()) return S21_SIZE_MISMATCH;
+  S21Matrix value;
+  s21_status status = guarded([&] { value = a->value * b->value; });
+  return status == S21_OK ? wrapResult(std::move(value), result) : status;
+}
+
+s21_status s21_matrix_transpose(const s21_matrix* matrix,
+                                s21_matrix** result) {
+  if (!matrix || !result) return S21_INVALID_ARGUMENT;
+  S21Matrix value;
+  s21_status status = guarded([&] { value = matrix->value.Transpose(); });
+  return status == S21_OK ? wrapResult(std::move(value), result) : status;
+}
+
+s21_status s21_matrix_determinant(const s21_matrix* matrix, double* result) {
+  if (!matrix || !result) return S21_INVALID_ARGUMENT;
+  if (matrix->value.GetRows() != matrix->value.GetCols()) {
+    return S21_SIZE_MISMATCH;
+  }
+  return guarded([&] { *result = matrix->value.Determinant(); });
+}
+
+s21_status s21_matrix_inverse(const s21_matrix* matrix, s21_matrix** result) {
+  if (!matrix || !result) return S21_INVALID_ARGUMENT;
+  if (matrix->value.GetRows() != matrix->value.GetCols()) {
+    return S21_SIZE_MISMATCH;
+  }
+  S21Matrix value;
+  s21_status status = guarded([&] { value = matrix->value.InverseMatrix(); });
+  return status == S21_OK ? wrapResult(std::move(value), result) : status;
+}
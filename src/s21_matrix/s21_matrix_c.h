@@ -0,0 +1,63 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_MATRIX_C_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_MATRIX_C_H_
+
+/* C interface to S21Matrix for foreign callers (Python, Rust, ...). Matrices
+ * are opaque handles released with s21_matrix_destroy; functions that can
+ * fail return an s21_status and never let a C++ exception escape. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct s21_matrix s21_matrix;
+
+typedef enum {
+  S21_OK = 0,
+  /* negative sizes, null pointers, short strides */
+  S21_INVALID_ARGUMENT = 1,
+  /* operand sizes do not match the operation */
+  S21_SIZE_MISMATCH = 2,
+  /* index outside the matrix */
+  S21_OUT_OF_RANGE = 3,
+  /* singular matrix and other numerical failures */
+  S21_CALCULATION_ERROR = 4,
+  S21_NO_MEMORY = 5
+} s21_status;
+
+typedef enum { S21_ROW_MAJOR = 0, S21_COL_MAJOR = 1 } s21_layout;
+
+/* zero-filled matrix owned by the library */
+s21_status s21_matrix_create(int rows, int cols, s21_matrix** result);
+/* borrows data without copying, the caller keeps it alive and unchanged in
+ * size until the handle is destroyed; stride 0 means packed */
+s21_status s21_matrix_wrap(double* data, int rows, int cols, s21_layout layout,
+                           int stride, s21_matrix** result);
+/* takes data without copying, release(context) is called once when the last
+ * matrix using the buffer is gone, e.g. to drop a Python reference; on
+ * failure it has already been called when the function returns */
+s21_status s21_matrix_adopt(double* data, int rows, int cols,
+                            s21_layout layout, int stride,
+                            void (*release)(void* context), void* context,
+                            s21_matrix** result);
+void s21_matrix_destroy(s21_matrix* matrix);
+
+int s21_matrix_rows(const s21_matrix* matrix);
+int s21_matrix_cols(const s21_matrix* matrix);
+s21_layout s21_matrix_layout(const s21_matrix* matrix);
+int s21_matrix_stride(const s21_matrix* matrix);
+/* first element, valid until the handle is destroyed or modified */
+double* s21_matrix_data(s21_matrix* matrix);
+
+s21_status s21_matrix_sum(const s21_matrix* a, const s21_matrix* b,
+                          s21_matrix** result);
+s21_status s21_matrix_mul(const s21_matrix* a, const s21_matrix* b,
+                          s21_matrix** result);
+s21_status s21_matrix_transpose(const s21_matrix* matrix, s21_matrix** result);
+s21_status s21_matrix_determinant(const s21_matrix* matrix, double* result);
+s21_status s21_matrix_inverse(const s21_matrix* matrix, s21_matrix** result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_MATRIX_C_H_
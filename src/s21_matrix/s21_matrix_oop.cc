@@ -1,56 +1,379 @@
 #include "s21_matrix/s21_matrix_oop.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "s21_matrix/s21_lu.h"
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+std::atomic<S21NumaPolicy> numa_policy{S21NumaPolicy::kDefault};
+
+// reciprocal condition number below which InverseMatrix refuses: the
+// inverse would have no correct digits
+constexpr double kSingularRcond = std::numeric_limits<double>::epsilon();
+
+// work between two checkpoints of an asynchronous operation
+constexpr long kPanelWork = 1L << 24;
+
+// runs work on a pool coordinator, its result or exception goes to the
+// returned future
+template <class Result, class Work>
+std::future<Result> submitTask(Work work) {
+  auto task = std::make_shared<std::packaged_task<Result()>>(std::move(work));
+  std::future<Result> result = task->get_future();
+  S21ThreadPool::Instance().Submit([task] { (*task)(); });
+  return result;
+}
+
+bool withinUlps(double a, double b, std::int64_t ulps) noexcept {
+  if (std::isnan(a) || std::isnan(b) || std::signbit(a) != std::signbit(b)) {
+    return false;
+  }
+  std::int64_t a_bits, b_bits;
+  std::memcpy(&a_bits, &a, sizeof(a));
+  std::memcpy(&b_bits, &b, sizeof(b));
+  // same-signed doubles are ordered like their bit patterns
+  return (a_bits > b_bits ? a_bits - b_bits : b_bits - a_bits) <= ulps;
+}
+
+bool elementsClose(double a, double b,
+                   const S21EqualityPolicy& policy) noexcept {
+  double diff = std::fabs(a - b);
+  return a == b || diff <= policy.absolute ||
+         diff <= policy.relative * std::max(std::fabs(a), std::fabs(b)) ||
+         (policy.ulps > 0 && withinUlps(a, b, policy.ulps));
+}
+
+// compares blocks with a branch-free loop the compiler vectorizes and stops
+// after the first block that holds a mismatch; only such a block is checked
+// again element by element for the exact and ULP criteria
+bool rangeClose(const double* a, const double* b, long size,
+                const S21EqualityPolicy& policy) noexcept {
+  constexpr long kBlock = 64;
+  const double absolute = policy.absolute;
+  const double relative = policy.relative;
+  for (long start = 0; start < size; start += kBlock) {
+    long end = std::min(size, start + kBlock);
+    bool mismatch = false;
+    for (auto i = start; i < end; i++) {
+      double diff = std::fabs(a[i] - b[i]);
+      double scale = std::max(std::fabs(a[i]), std::fabs(b[i]));
+      mismatch |= !((diff <= absolute) | (diff <= relative * scale));
+    }
+    if (mismatch) {
+      for (auto i = start; i < end; i++) {
+        if (!elementsClose(a[i], b[i], policy)) return false;
+      }
+    }
+  }
+  return true;
+}
+
+void checkBuffer(const double* data, int rows, int cols, S21Layout layout,
+                 int stride) {
+  if (rows < 0 || cols < 0) {
+    throw std::invalid_argument("Rows and columns must be positive");
+  }
+  if (stride < 0 ||
+      (stride > 0 && stride < (layout == S21Layout::kRowMajor ? cols : rows))) {
+    throw std::invalid_argument("Stride is shorter than a row or column");
+  }
+  if (!data && rows > 0 && cols > 0) {
+    throw std::invalid_argument("Buffer must not be null");
+  }
+}
+}  // namespace
+
+struct S21Matrix::Storage {
+  Storage(int rows, int cols, bool zeroed)
+      : refs(1),
+        data(nullptr),
+        bytes(static_cast<std::size_t>(rows) * cols * sizeof(double)),
+        mapped(false),
+        borrowed(false) {
+    S21NumaPolicy policy = numa_policy.load(std::memory_order_relaxed);
+    if (policy != S21NumaPolicy::kDefault && bytes >= S21Numa::kMinBytes) {
+      data = static_cast<double*>(S21Numa::AllocatePages(bytes));
+    }
+    if (!data) {
+      std::size_t size = static_cast<std::size_t>(rows) * cols;
+      data = zeroed ? new double[size]{} : new double[size];
+      return;
+    }
+    mapped = true;
+    if (policy == S21NumaPolicy::kInterleave) {
+      S21Numa::Interleave(data, bytes);
+    } else if (zeroed) {
+      // the fresh pages are already zero, writing them places each block of
+      // rows on the node of the worker that owns it; uninitialized matrices
+      // leave that to their producer, which runs on the same row blocks
+      S21ThreadPool::ParallelRows(
+          rows, S21ThreadPool::kParallelMinWork, [&](long begin, long end) {
+            std::memset(data + begin * cols, 0,
+                        (end - begin) * cols * sizeof(double));
+          });
+    }
+  }
+  // buffer from outside, owned through keep_alive, borrowed, or else owned
+  // by this storage and freed with delete[]
+  Storage(double* external, std::shared_ptr<double[]> keep_alive,
+          bool borrowed)
+      : refs(1),
+        data(external),
+        bytes(0),
+        mapped(false),
+        borrowed(borrowed),
+        keep_alive(std::move(keep_alive)) {}
+  ~Storage() {
+    if (borrowed || keep_alive) {
+      return;
+    } else if (mapped) {
+      S21Numa::FreePages(data, bytes);
+    } else {
+      delete[] data;
+    }
+  }
+
+  std::atomic<long> refs;
+  double* data;
+  std::size_t bytes;
+  bool mapped;
+  bool borrowed;
+  std::shared_ptr<double[]> keep_alive;
+};
+
+template <class Body>
+void S21Matrix::forEachIndex(Body body) const {
+  // walks the lines of the storage order so this matrix streams through
+  // memory, blocks of lines go to the thread pool
+  if (layout_ == S21Layout::kRowMajor) {
+    S21ThreadPool::ParallelRows(rows_, cols_, [&](long begin, long end) {
+      for (auto i = static_cast<int>(begin); i < end; i++) {
+        for (auto j = 0; j < cols_; j++) body(i, j);
+      }
+    });
+  } else {
+    S21ThreadPool::ParallelRows(cols_, rows_, [&](long begin, long end) {
+      for (auto j = static_cast<int>(begin); j < end; j++) {
+        for (auto i = 0; i < rows_; i++) body(i, j);
+      }
+    });
+  }
+}
+
+template <class Op>
+void S21Matrix::forEachElement(Op op) {
+  detachMatrix();
+  if (IsContiguous()) {
+    S21ThreadPool::ParallelRows(rows_, cols_, [&](long begin, long end) {
+      for (auto i = begin * cols_; i < end * cols_; i++) {
+        op(matrix_[i]);
+      }
+    });
+  } else {
+    forEachIndex([&](int i, int j) { op(matrix_[offset(i, j)]); });
+  }
+}
+
+template <class Op>
+void S21Matrix::zipWith(const S21Matrix& other, Op op) {
+  detachMatrix();
+  if (sameOrder(other)) {
+    S21ThreadPool::ParallelRows(rows_, cols_, [&](long begin, long end) {
+      for (auto i = begin * cols_; i < end * cols_; i++) {
+        op(matrix_[i], other.matrix_[i]);
+      }
+    });
+  } else {
+    forEachIndex([&](int i, int j) {
+      op(matrix_[offset(i, j)], other.matrix_[other.offset(i, j)]);
+    });
+  }
+}
+
 // default constructor
-S21Matrix::S21Matrix() noexcept : rows_(0), cols_(0), matrix_(nullptr) {}
+S21Matrix::S21Matrix() noexcept
+    : rows_(0),
+      cols_(0),
+      matrix_(nullptr),
+      storage_(nullptr),
+      layout_(S21Layout::kRowMajor),
+      row_stride_(0),
+      col_stride_(1),
+      shared_(false) {}
 
 // parameterized constructor
-S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
-  if (rows_ < 0 || cols_ < 0) {
+S21Matrix::S21Matrix(int rows, int cols) : S21Matrix() {
+  if (rows < 0 || cols < 0) {
     throw std::invalid_argument("Rows and columns must be positive");
   }
+  rows_ = rows;
+  cols_ = cols;
   createMatrix();
 }
 
-void S21Matrix::createMatrix() {
+// parameterized constructor with a storage order
+S21Matrix::S21Matrix(int rows, int cols, S21Layout layout) : S21Matrix() {
+  if (rows < 0 || cols < 0) {
+    throw std::invalid_argument("Rows and columns must be positive");
+  }
+  rows_ = rows;
+  cols_ = cols;
+  createMatrix(true, layout);
+}
+
+// uninitialized constructor
+S21Matrix::S21Matrix(int rows, int cols, Uninitialized) : S21Matrix() {
+  if (rows < 0 || cols < 0) {
+    throw std::invalid_argument("Rows and columns must be positive");
+  }
+  rows_ = rows;
+  cols_ = cols;
+  createMatrix(false);
+}
+
+// adopting constructors
+S21Matrix::S21Matrix(std::unique_ptr<double[]> data, int rows, int cols,
+                     S21Layout layout, int stride)
+    : S21Matrix() {
+  checkBuffer(data.get(), rows, cols, layout, stride);
+  rows_ = rows;
+  cols_ = cols;
+  if (rows_ > 0 && cols_ > 0) {
+    adoptStorage(new Storage(data.get(), nullptr, false), layout, stride);
+    data.release();
+  }
+}
+
+S21Matrix::S21Matrix(std::shared_ptr<double[]> data, int rows, int cols,
+                     S21Layout layout, int stride)
+    : S21Matrix() {
+  checkBuffer(data.get(), rows, cols, layout, stride);
+  rows_ = rows;
+  cols_ = cols;
+  if (rows_ > 0 && cols_ > 0) {
+    double* elements = data.get();
+    adoptStorage(new Storage(elements, std::move(data), false), layout,
+                 stride);
+  }
+}
+
+S21MatrixView S21Matrix::Wrap(double* data, int rows, int cols,
+                              S21Layout layout, int stride) {
+  return S21MatrixView(data, rows, cols, layout, stride);
+}
+
+S21MatrixView::S21MatrixView(double* data, int rows, int cols,
+                             S21Layout layout, int stride) {
+  checkBuffer(data, rows, cols, layout, stride);
+  rows_ = rows;
+  cols_ = cols;
+  if (rows > 0 && cols > 0) {
+    adoptStorage(new Storage(data, nullptr, true), layout, stride);
+  }
+}
+
+void S21Matrix::createMatrix(bool zeroed, S21Layout layout) {
+  layout_ = layout;
   if (rows_ == 0 || cols_ == 0) {
     matrix_ = nullptr;
+    storage_ = nullptr;
   } else if (rows_ > 0 && cols_ > 0) {
-    matrix_ = new double*[rows_];
-    for (auto i = 0; i < rows_; i++) {
-      matrix_[i] = new double[cols_]{};
+    adoptStorage(new Storage(rows_, cols_, zeroed), layout, 0);
+  }
+}
+
+void S21Matrix::shareStorage(const S21Matrix& other) noexcept {
+  other.storage_->refs.fetch_add(1, std::memory_order_relaxed);
+  storage_ = other.storage_;
+  matrix_ = other.matrix_;
+  layout_ = other.layout_;
+  row_stride_ = other.row_stride_;
+  col_stride_ = other.col_stride_;
+}
+
+void S21Matrix::adoptStorage(Storage* storage, S21Layout layout, int stride) {
+  storage_ = storage;
+  matrix_ = storage->data;
+  layout_ = layout;
+  if (layout == S21Layout::kRowMajor) {
+    row_stride_ = stride ? stride : cols_;
+    col_stride_ = 1;
+  } else {
+    row_stride_ = 1;
+    col_stride_ = stride ? stride : rows_;
+  }
+}
+
+long S21Matrix::offset(int row, int col) const noexcept {
+  return static_cast<long>(row) * row_stride_ +
+         static_cast<long>(col) * col_stride_;
+}
+
+bool S21Matrix::isBorrowed() const noexcept {
+  return storage_ && storage_->borrowed;
+}
+
+bool S21Matrix::sameOrder(const S21Matrix& other) const noexcept {
+  return layout_ == other.layout_ && IsContiguous() && other.IsContiguous();
+}
+
+void S21Matrix::copyElements(const S21Matrix& other) {
+  if (sameOrder(other)) {
+    if (matrix_) {
+      std::memcpy(matrix_, other.matrix_,
+                  static_cast<std::size_t>(rows_) * cols_ * sizeof(double));
     }
+  } else {
+    zipWith(other, [](double& x, double y) { x = y; });
   }
 }
 
+void S21Matrix::releaseMatrix() noexcept {
+  if (storage_ && storage_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete storage_;
+  }
+  storage_ = nullptr;
+  matrix_ = nullptr;
+}
+
+void S21Matrix::detachMatrix() {
+  if (!storage_ || storage_->refs.load(std::memory_order_acquire) == 1) {
+    return;
+  }
+  S21Matrix copy;
+  copy.rows_ = rows_;
+  copy.cols_ = cols_;
+  copy.shared_ = shared_;
+  copy.createMatrix(false, layout_);
+  copy.copyElements(*this);
+  *this = std::move(copy);
+}
+
 // copy constructor
-S21Matrix::S21Matrix(const S21Matrix& other)
-    : rows_(other.rows_), cols_(other.cols_) {
-  createMatrix();
-  for (auto i = 0; i < rows_; i++) {
-    for (auto j = 0; j < cols_; j++) {
-      (*this)(i, j) = other(i, j);
-    }
+S21Matrix::S21Matrix(const S21Matrix& other) : S21Matrix() {
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  shared_ = other.shared_;
+  if (other.shared_ && other.storage_ && !other.storage_->borrowed) {
+    shareStorage(other);
+  } else {
+    createMatrix(false, other.layout_);
+    copyElements(other);
   }
 }
 
 // move constructor
-S21Matrix::S21Matrix(S21Matrix&& other) noexcept {
-  this->rows_ = 0;
-  this->cols_ = 0;
-  this->matrix_ = nullptr;
-
+S21Matrix::S21Matrix(S21Matrix&& other) noexcept : S21Matrix() {
   *this = std::move(other);
 }
 
 // destructor
-S21Matrix::~S21Matrix() {
-  if (matrix_) {
-    for (auto i = 0; i < rows_; i++) {
-      if (matrix_[i]) delete[] matrix_[i];
-    }
-    delete[] matrix_;
-  }
-}
+S21Matrix::~S21Matrix() { releaseMatrix(); }
 
 // getter of rows
 int S21Matrix::GetRows() const noexcept { return rows_; }
@@ -58,35 +381,144 @@ int S21Matrix::GetRows() const noexcept { return rows_; }
 // getter of cols
 int S21Matrix::GetCols() const noexcept { return cols_; }
 
+S21Layout S21Matrix::GetLayout() const noexcept { return layout_; }
+
+int S21Matrix::GetStride() const noexcept {
+  return layout_ == S21Layout::kRowMajor ? row_stride_ : col_stride_;
+}
+
+bool S21Matrix::IsContiguous() const noexcept {
+  if (layout_ == S21Layout::kRowMajor) {
+    return row_stride_ == cols_ || rows_ <= 1;
+  }
+  return col_stride_ == rows_ || cols_ <= 1;
+}
+
+double* S21Matrix::data() {
+  detachMatrix();
+  return matrix_;
+}
+
+const double* S21Matrix::data() const noexcept { return matrix_; }
+
+void S21Matrix::SetShared(bool shared) noexcept { shared_ = shared; }
+
+bool S21Matrix::IsShared() const noexcept { return shared_; }
+
+long S21Matrix::UseCount() const noexcept {
+  return storage_ ? storage_->refs.load(std::memory_order_relaxed) : 0;
+}
+
+void S21Matrix::SetNumaPolicy(S21NumaPolicy policy) noexcept {
+  numa_policy.store(policy, std::memory_order_relaxed);
+  // the default placement leaves the scheduler alone
+  S21ThreadPool::Instance().SetPinned(policy != S21NumaPolicy::kDefault);
+}
+
+S21NumaPolicy S21Matrix::GetNumaPolicy() noexcept {
+  return numa_policy.load(std::memory_order_relaxed);
+}
+
+void S21Matrix::Fill(double value) {
+  forEachElement([value](double& x) { x = value; });
+}
+
+S21Matrix S21Matrix::Identity(int size) {
+  S21Matrix result(size, size, uninitialized);
+  double* out = result.matrix_;
+  S21ThreadPool::ParallelRows(size, size, [&](long begin, long end) {
+    for (auto i = begin; i < end; i++) {
+      for (auto j = 0; j < size; j++) {
+        out[i * size + j] = i == j ? 1.0 : 0.0;
+      }
+    }
+  });
+  return result;
+}
+
+S21Matrix S21Matrix::Random(int rows, int cols, std::uint64_t seed,
+                            Distribution distribution) {
+  S21Matrix result(rows, cols, uninitialized);
+  double* out = result.matrix_;
+  S21ThreadPool::ParallelRows(rows, cols, [&](long begin, long end) {
+    for (auto i = begin; i < end; i++) {
+      // one engine per row keeps the values independent of the partitioning
+      std::mt19937_64 engine(seed ^ (0x9E3779B97F4A7C15ULL * (i + 1)));
+      std::uniform_real_distribution<double> uniform(0.0, 1.0);
+      std::normal_distribution<double> normal(0.0, 1.0);
+      for (auto j = 0; j < cols; j++) {
+        out[i * cols + j] = distribution == Distribution::kNormal
+                                ? normal(engine)
+                                : uniform(engine);
+      }
+    }
+  });
+  return result;
+}
+
+S21Matrix S21Matrix::FromGenerator(
+    int rows, int cols, const std::function<double(int, int)>& generator) {
+  S21Matrix result(rows, cols, uninitialized);
+  double* out = result.matrix_;
+  S21ThreadPool::ParallelRows(rows, cols, [&](long begin, long end) {
+    for (auto i = begin; i < end; i++) {
+      for (auto j = 0; j < cols; j++) {
+        out[i * cols + j] = generator(static_cast<int>(i), j);
+      }
+    }
+  });
+  return result;
+}
+
 // setter for rows
 void S21Matrix::SetRows(int rows) {
-  S21Matrix temp(rows, cols_);
+  checkResize(rows, cols_);
+  S21Matrix temp(rows, cols_, layout_);
   for (auto i = 0; i < rows_ && i < rows; i++) {
     for (auto j = 0; j < cols_; j++) {
       temp(i, j) = (*this)(i, j);
     }
   }
-  *this = std::move(temp);
+  temp.shared_ = shared_;
+  replaceWith(std::move(temp));
 };
 
 // setter for cols
 void S21Matrix::SetCols(int cols) {
-  S21Matrix temp(rows_, cols);
+  checkResize(rows_, cols);
+  S21Matrix temp(rows_, cols, layout_);
   for (auto i = 0; i < rows_; i++) {
     for (auto j = 0; j < cols_ && j < cols; j++) {
       temp(i, j) = (*this)(i, j);
     }
   }
-  *this = std::move(temp);
+  temp.shared_ = shared_;
+  replaceWith(std::move(temp));
 };
 
 bool S21Matrix::EqMatrix(const S21Matrix& other) const noexcept {
-  if (rows_ != other.rows_ && cols_ != other.cols_) {
+  return EqMatrix(other, S21EqualityPolicy());
+}
+
+bool S21Matrix::EqMatrix(const S21Matrix& other,
+                         const S21EqualityPolicy& policy) const noexcept {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
     return false;
   }
-  for (auto i = 0; i < rows_; i++) {
-    for (auto j = 0; j < cols_; j++) {
-      if (std::fabs(this->matrix_[i][j] - other.matrix_[i][j]) > 1e-7) {
+  if (sameOrder(other)) {
+    return rangeClose(matrix_, other.matrix_,
+                      static_cast<long>(rows_) * cols_, policy);
+  }
+  // lines along the storage order of this matrix
+  bool by_rows = layout_ == S21Layout::kRowMajor;
+  int lines = by_rows ? rows_ : cols_;
+  int length = by_rows ? cols_ : rows_;
+  for (auto line = 0; line < lines; line++) {
+    for (auto k = 0; k < length; k++) {
+      int i = by_rows ? line : k;
+      int j = by_rows ? k : line;
+      if (!elementsClose(matrix_[offset(i, j)],
+                         other.matrix_[other.offset(i, j)], policy)) {
         return false;
       }
     }
@@ -94,16 +526,46 @@ bool S21Matrix::EqMatrix(const S21Matrix& other) const noexcept {
   return true;
 }
 
+std::size_t S21MatrixHash::operator()(const S21Matrix& matrix) const noexcept {
+  std::uint64_t hash =
+      (static_cast<std::uint64_t>(matrix.rows_) << 32) ^ matrix.cols_;
+  auto mix = [&hash](double value) {
+    // -0.0 equals 0.0, so both hash alike
+    value = value == 0.0 ? 0.0 : value;
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    hash = (hash ^ bits) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+  };
+  // row by row whatever the layout, so equal matrices hash alike
+  if (matrix.layout_ == S21Layout::kRowMajor && matrix.IsContiguous()) {
+    for (auto i = 0L; i < static_cast<long>(matrix.rows_) * matrix.cols_;
+         i++) {
+      mix(matrix.matrix_[i]);
+    }
+  } else {
+    for (auto i = 0; i < matrix.rows_; i++) {
+      for (auto j = 0; j < matrix.cols_; j++) {
+        mix(matrix.matrix_[matrix.offset(i, j)]);
+      }
+    }
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+bool S21MatrixExactEqual::operator()(const S21Matrix& a,
+                                     const S21Matrix& b) const noexcept {
+  S21EqualityPolicy exact;
+  exact.absolute = 0.0;
+  return a.EqMatrix(b, exact);
+}
+
 void S21Matrix::SumMatrix(const S21Matrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) {
     throw std::logic_error(
         "Incorrect input, matrices should have the same size.");
   }
-  for (auto i = 0; i < rows_; i++) {
-    for (auto j = 0; j < cols_; j++) {
-      (*this)(i, j) += other(i, j);
-    }
-  }
+  zipWith(other, [](double& x, double y) { x += y; });
 }
 
 void S21Matrix::SubMatrix(const S21Matrix& other) {
@@ -111,19 +573,11 @@ void S21Matrix::SubMatrix(const S21Matrix& other) {
     throw std::logic_error(
         "Incorrect input, matrices should have the same size.");
   }
-  for (auto i = 0; i < rows_; i++) {
-    for (auto j = 0; j < cols_; j++) {
-      (*this)(i, j) -= other(i, j);
-    }
-  }
+  zipWith(other, [](double& x, double y) { x -= y; });
 }
 
-void S21Matrix::MulNumber(const double num) noexcept {
-  for (auto i = 0; i < rows_; i++) {
-    for (auto j = 0; j < cols_; j++) {
-      (*this)(i, j) *= num;
-    }
-  }
+void S21Matrix::MulNumber(const double num) {
+  forEachElement([num](double& x) { x *= num; });
 }
 
 void S21Matrix::MulMatrix(const S21Matrix& other) {
@@ -132,41 +586,268 @@ void S21Matrix::MulMatrix(const S21Matrix& other) {
         "Incorrect input, the number of inputed rows must be equal to the "
         "number of columns of the first matrix.");
   }
-  S21Matrix result(rows_, other.cols_);
-  for (auto i = 0; i < rows_; i++) {
-    for (auto j = 0; j < other.cols_; j++) {
-      result(i, j) = 0;
-      for (auto k = 0; k < cols_; k++) {
-        result(i, j) += (*this)(i, k) * other(k, j);
+  checkResize(rows_, other.cols_);
+  S21Matrix result;
+  result.assignProduct(*this, other);
+  result.shared_ = shared_;
+  replaceWith(std::move(result));
+}
+
+void S21Matrix::checkResize(int rows, int cols) const {
+  if (isBorrowed() && (rows != rows_ || cols != cols_)) {
+    throw std::logic_error(
+        "Incorrect input, a wrapped matrix cannot change its size.");
+  }
+}
+
+void S21Matrix::replaceWith(S21Matrix&& result) {
+  if (isBorrowed()) {
+    // writes go to the wrapped buffer, checkResize kept the shape
+    copyElements(result);
+  } else {
+    *this = std::move(result);
+  }
+}
+
+void S21Matrix::assignProduct(const S21Matrix& a, const S21Matrix& b) {
+  // the loop order keeps the innermost loop on unit-stride data for every
+  // combination of layouts: a row-major stride is 1 along a row and a
+  // column-major stride is 1 along a column
+  const int m = a.rows_;
+  const int n = b.cols_;
+  const int inner = a.cols_;
+  const bool col_major = a.layout_ == S21Layout::kColMajor &&
+                         b.layout_ == S21Layout::kColMajor;
+  const S21Layout layout =
+      col_major ? S21Layout::kColMajor : S21Layout::kRowMajor;
+  bool reusable = storage_ && !storage_->borrowed &&
+                  storage_->refs.load(std::memory_order_acquire) == 1 &&
+                  storage_ != a.storage_ && storage_ != b.storage_ &&
+                  rows_ == m && cols_ == n && layout_ == layout &&
+                  IsContiguous();
+  if (!reusable) {
+    S21Matrix fresh;
+    fresh.rows_ = m;
+    fresh.cols_ = n;
+    fresh.shared_ = shared_;
+    fresh.createMatrix(false, layout);
+    *this = std::move(fresh);
+  }
+  double* c = matrix_;
+  const double* a_data = a.matrix_;
+  const double* b_data = b.matrix_;
+  if (col_major) {
+    // c(:, j) += a(:, k) * b(k, j), the result is column-major as well
+    S21ThreadPool::ParallelRows(
+        n, static_cast<long>(inner) * m, [&](long begin, long end) {
+          for (auto j = begin; j < end; j++) {
+            double* c_col = c + j * m;
+            std::fill(c_col, c_col + m, 0.0);
+            for (auto k = 0; k < inner; k++) {
+              const double* a_col = a_data + k * a.col_stride_;
+              double b_kj = b_data[k + j * b.col_stride_];
+              for (auto i = 0; i < m; i++) {
+                c_col[i] += a_col[i] * b_kj;
+              }
+            }
+          }
+        });
+  } else if (b.layout_ == S21Layout::kColMajor) {
+    // a is row-major: dot products of a row of a and a column of b
+    S21ThreadPool::ParallelRows(
+        m, static_cast<long>(inner) * n, [&](long begin, long end) {
+          for (auto i = begin; i < end; i++) {
+            const double* a_row = a_data + i * a.row_stride_;
+            for (auto j = 0; j < n; j++) {
+              const double* b_col = b_data + j * b.col_stride_;
+              double sum = 0;
+              for (auto k = 0; k < inner; k++) {
+                sum += a_row[k] * b_col[k];
+              }
+              c[i * n + j] = sum;
+            }
+          }
+        });
+  } else {
+    // b is row-major: c(i, :) += a(i, k) * b(k, :)
+    S21ThreadPool::ParallelRows(
+        m, static_cast<long>(inner) * n, [&](long begin, long end) {
+          for (auto i = begin; i < end; i++) {
+            double* c_row = c + i * n;
+            std::fill(c_row, c_row + n, 0.0);
+            for (auto k = 0; k < inner; k++) {
+              double a_ik = a_data[a.offset(static_cast<int>(i), k)];
+              const double* b_row = b_data + k * b.row_stride_;
+              for (auto j = 0; j < n; j++) {
+                c_row[j] += a_ik * b_row[j];
+              }
+            }
+          }
+        });
+  }
+}
+
+S21Matrix S21Matrix::Pow(int power) const {
+  if (rows_ != cols_) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  if (power < 0) {
+    // -(power + 1) + 1 stays representable for INT_MIN
+    S21Matrix inverse = InverseMatrix();
+    S21Matrix result = inverse.Pow(-(power + 1));
+    result.MulMatrix(inverse);
+    return result;
+  }
+  if (power == 0) {
+    return Identity(rows_);
+  }
+  // binary exponentiation with three buffers: the squares of the base, the
+  // running product and one scratch product that is swapped in
+  S21Matrix base = ToLayout(S21Layout::kRowMajor);
+  S21Matrix result;
+  S21Matrix scratch;
+  bool started = false;
+  for (unsigned int bits = power; bits; bits >>= 1) {
+    if (bits & 1) {
+      if (started) {
+        scratch.assignProduct(result, base);
+        std::swap(result, scratch);
+      } else {
+        result = base;
+        started = true;
       }
     }
+    if (bits > 1) {
+      scratch.assignProduct(base, base);
+      std::swap(base, scratch);
+    }
   }
-  *this = std::move(result);
+  return result;
 }
 
-S21Matrix S21Matrix::Transpose() const {
-  S21Matrix result(cols_, rows_);
-  for (auto i = 0; i < rows_; i++) {
-    for (auto j = 0; j < cols_; j++) {
-      result(j, i) = (*this)(i, j);
-    }
+S21Matrix S21Matrix::Exp() const {
+  if (rows_ != cols_) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  // [13/13] Pade approximant with scaling and squaring, Higham (2005):
+  // exp(A) = exp(A / 2^s)^(2^s) with ||A / 2^s||_1 <= theta_13
+  constexpr double kTheta13 = 5.371920351148152;
+  constexpr double kPade[] = {64764752532480000.0,
+                              32382376266240000.0,
+                              7771770303897600.0,
+                              1187353796428800.0,
+                              129060195264000.0,
+                              10559470521600.0,
+                              670442572800.0,
+                              33522128640.0,
+                              1323241920.0,
+                              40840800.0,
+                              960960.0,
+                              16380.0,
+                              182.0,
+                              1.0};
+  const int n = rows_;
+  if (n == 0) {
+    return S21Matrix();
+  }
+  double norm = 0.0;
+  for (auto j = 0; j < n; j++) {
+    double column = 0.0;
+    for (auto i = 0; i < n; i++) column += std::fabs((*this)(i, j));
+    norm = std::max(norm, column);
+  }
+  int squarings = 0;
+  if (norm > kTheta13) {
+    squarings = static_cast<int>(std::ceil(std::log2(norm / kTheta13)));
+  }
+
+  S21Matrix a = ToLayout(S21Layout::kRowMajor) * std::ldexp(1.0, -squarings);
+  S21Matrix identity = Identity(n);
+  S21Matrix a2 = a * a;
+  S21Matrix a4 = a2 * a2;
+  S21Matrix a6 = a4 * a2;
+  S21Matrix u = a6 * (a6 * kPade[13] + a4 * kPade[11] + a2 * kPade[9]);
+  u += a6 * kPade[7] + a4 * kPade[5] + a2 * kPade[3] + identity * kPade[1];
+  u = a * u;
+  S21Matrix v = a6 * (a6 * kPade[12] + a4 * kPade[10] + a2 * kPade[8]);
+  v += a6 * kPade[6] + a4 * kPade[4] + a2 * kPade[2] + identity * kPade[0];
+
+  // (V - U) X = V + U
+  S21Matrix result = S21LU(v - u).Solve(v + u);
+  S21Matrix scratch;
+  for (auto i = 0; i < squarings; i++) {
+    scratch.assignProduct(result, result);
+    std::swap(result, scratch);
   }
   return result;
 }
 
+S21Matrix S21Matrix::Transpose() const& {
+  if (!shared_ || isBorrowed()) {
+    // sharing is opt-in and a view would extend the borrow, transpose a
+    // private copy instead
+    S21Matrix copy;
+    copy.rows_ = rows_;
+    copy.cols_ = cols_;
+    copy.createMatrix(false, layout_);
+    copy.copyElements(*this);
+    return std::move(copy).Transpose();
+  }
+  S21Matrix result;
+  result.rows_ = rows_;
+  result.cols_ = cols_;
+  result.shared_ = true;
+  if (storage_) {
+    result.shareStorage(*this);
+  }
+  return std::move(result).Transpose();
+}
+
+S21Matrix S21Matrix::Transpose() && {
+  // borrowed storage never moves out of its view
+  if (isBorrowed()) return static_cast<const S21Matrix&>(*this).Transpose();
+  // element (i, j) of the transpose sits where (j, i) is, so swapping the
+  // strides and the storage order is enough
+  std::swap(rows_, cols_);
+  std::swap(row_stride_, col_stride_);
+  layout_ = layout_ == S21Layout::kRowMajor ? S21Layout::kColMajor
+                                            : S21Layout::kRowMajor;
+  return std::move(*this);
+}
+
+S21Matrix S21Matrix::ToLayout(S21Layout layout) const {
+  if (layout == layout_ && IsContiguous()) {
+    return *this;
+  }
+  S21Matrix result;
+  result.rows_ = rows_;
+  result.cols_ = cols_;
+  result.shared_ = shared_;
+  result.createMatrix(false, layout);
+  result.copyElements(*this);
+  return result;
+}
+
 double S21Matrix::Determinant() const {
   if (rows_ != cols_) {
     throw std::logic_error("The matrix is not square.");
   }
-  double result = 0.0;
-  if (rows_ == 1) {
-    result = (*this)(0, 0);
-  } else {
-    for (auto i = 0; i < cols_; i++) {
-      S21Matrix temp = GetMinor(0, i);
-      result += pow(-1, i + 2) * (*this)(0, i) * temp.Determinant();
+  // serial scan for a triangular matrix, stopping at the first nonzero
+  // element on each side of the diagonal
+  bool lower = true, upper = true;
+  for (auto i = 0; i < rows_ && (lower || upper); i++) {
+    for (auto j = 0; j < cols_ && (lower || upper); j++) {
+      if (i != j && matrix_[offset(i, j)] != 0.0) {
+        (j > i ? lower : upper) = false;
+      }
     }
   }
+  if (!lower && !upper) {
+    return S21LU(*this).Determinant();
+  }
+  // triangular: the product of the diagonal
+  double result = 1.0;
+  for (auto i = 0; i < rows_; i++) result *= matrix_[offset(i, i)];
   return result;
 }
 
@@ -178,22 +859,14 @@ S21Matrix S21Matrix::GetMinor(int rows, int cols) const {
     throw std::logic_error("The matrix is not square.");
   }
 
-  S21Matrix result(rows_ - 1, cols_ - 1);
-  int current_row = 0;
-  for (auto i = 0; i < rows_; i++) {
-    if (i == rows) {
-      continue;
-    }
-    int current_col = 0;
-    for (auto j = 0; j < cols_; j++) {
-      if (j == cols) {
-        continue;
-      }
-      result(current_row, current_col) = (*this)(i, j);
-      current_col++;
-    }
-    current_row++;
-  }
+  S21Matrix result;
+  result.rows_ = rows_ - 1;
+  result.cols_ = cols_ - 1;
+  result.createMatrix(false, layout_);
+  result.forEachIndex([&](int i, int j) {
+    result.matrix_[result.offset(i, j)] =
+        matrix_[offset(i < rows ? i : i + 1, j < cols ? j : j + 1)];
+  });
   return result;
 }
 
@@ -201,7 +874,7 @@ S21Matrix S21Matrix::CalcComplements() const {
   if (rows_ <= 0 || cols_ <= 0) {
     throw std::out_of_range("Rows and columns must be positive.");
   }
-  S21Matrix result(rows_, cols_);
+  S21Matrix result(rows_, cols_, uninitialized);
   if (rows_ == 1 && cols_ == 1) {
     result(0, 0) = 1;
   } else {
@@ -215,12 +888,142 @@ S21Matrix S21Matrix::CalcComplements() const {
 }
 
 S21Matrix S21Matrix::InverseMatrix() const {
-  double det = Determinant();
-  if (std::fabs(det) < 1e-7) {
-    throw std::logic_error("Zero determinant.");
+  if (rows_ != cols_) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  S21LU lu(*this);
+  if (lu.IsSingular(kSingularRcond)) {
+    throw std::logic_error("The matrix is singular.");
+  }
+  return lu.Inverse();
+}
+
+double S21Matrix::Rcond() const { return S21LU(*this).Rcond(); }
+
+bool S21Matrix::IsSingular(double tolerance) const {
+  return S21LU(*this).IsSingular(tolerance);
+}
+
+// a negative tolerance picks the default one
+int S21Matrix::Rank() const { return Rank(-1.0); }
+
+int S21Matrix::Rank(double tolerance) const {
+  // elimination with complete pivoting, which unlike partial pivoting leaves
+  // the rank in the size of the pivots
+  const int m = rows_;
+  const int n = cols_;
+  S21Matrix work = ToLayout(S21Layout::kRowMajor);
+  double* a = work.data();
+  std::vector<int> cols(n);
+  for (auto j = 0; j < n; j++) cols[j] = j;
+  int rank = 0;
+  for (auto k = 0; k < std::min(m, n); k++) {
+    int pivot_row = k, pivot_col = k;
+    for (auto i = k; i < m; i++) {
+      for (auto j = k; j < n; j++) {
+        if (std::fabs(a[i * n + cols[j]]) >
+            std::fabs(a[pivot_row * n + cols[pivot_col]])) {
+          pivot_row = i;
+          pivot_col = j;
+        }
+      }
+    }
+    double pivot = a[pivot_row * n + cols[pivot_col]];
+    if (k == 0 && tolerance < 0.0) {
+      tolerance = std::max(m, n) * std::fabs(pivot) *
+                  std::numeric_limits<double>::epsilon();
+    }
+    if (std::fabs(pivot) <= tolerance || pivot == 0.0) break;
+    rank++;
+    std::swap_ranges(a + k * n, a + (k + 1) * n, a + pivot_row * n);
+    std::swap(cols[k], cols[pivot_col]);
+    for (auto i = k + 1; i < m; i++) {
+      double factor = a[i * n + cols[k]] / pivot;
+      for (auto j = k + 1; j < n; j++) {
+        a[i * n + cols[j]] -= factor * a[k * n + cols[j]];
+      }
+    }
+  }
+  return rank;
+}
+
+std::future<S21Matrix> S21Matrix::MulMatrixAsync(
+    const S21Matrix& other, const S21TaskControl& control) const {
+  if (cols_ != other.rows_) {
+    throw std::logic_error(
+        "Incorrect input, the number of inputed rows must be equal to the "
+        "number of columns of the first matrix.");
   }
+  return submitTask<S21Matrix>([a = *this, b = other, control]() mutable {
+    const int m = a.rows_;
+    const int n = b.cols_;
+    const long work_per_row = std::max(1L, static_cast<long>(a.cols_) * n);
+    // panels big enough to keep the pool busy, small enough to cancel soon
+    const int panel = static_cast<int>(std::min<long>(
+        m, std::max(1L, kPanelWork / work_per_row)));
+    S21Matrix result(m, n, uninitialized);
+    S21Matrix product;
+    double* base = a.data();
+    for (auto first = 0; first < m; first += panel) {
+      control.Checkpoint(static_cast<double>(first) / std::max(m, 1));
+      const int rows = std::min(panel, m - first);
+      const bool row_major = a.layout_ == S21Layout::kRowMajor;
+      S21MatrixView view = Wrap(
+          base + (row_major ? static_cast<long>(first) * a.row_stride_ : first),
+          rows, a.cols_, a.layout_, row_major ? a.row_stride_ : a.col_stride_);
+      product.assignProduct(view, b);
+      product.forEachIndex([&](int i, int j) {
+        result.matrix_[static_cast<long>(first + i) * n + j] =
+            product.matrix_[product.offset(i, j)];
+      });
+    }
+    control.Checkpoint(1.0);
+    return result;
+  });
+}
 
-  return CalcComplements().Transpose() * (1 / det);
+std::future<S21Matrix> S21Matrix::InverseMatrixAsync(
+    const S21TaskControl& control) const {
+  if (rows_ != cols_) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  return submitTask<S21Matrix>([a = *this, control] {
+    // elimination is about a quarter of the flops, the solves the rest
+    S21LU lu(a, control.Stage(0.0, 0.25));
+    if (lu.IsSingular(kSingularRcond)) {
+      throw std::logic_error("The matrix is singular.");
+    }
+    const int n = a.rows_;
+    const int panel = static_cast<int>(std::min<long>(
+        n, std::max(1L, kPanelWork / std::max(1L, 2L * n * n))));
+    const S21TaskControl solves = control.Stage(0.25, 1.0);
+    S21Matrix result(n, n, uninitialized);
+    for (auto first = 0; first < n; first += panel) {
+      solves.Checkpoint(static_cast<double>(first) / n);
+      // columns first .. first + cols of the identity
+      const int cols = std::min(panel, n - first);
+      S21Matrix unit(n, cols);
+      for (auto j = 0; j < cols; j++) unit(first + j, j) = 1.0;
+      S21Matrix x = lu.Solve(unit);
+      for (auto i = 0; i < n; i++) {
+        for (auto j = 0; j < cols; j++) result(i, first + j) = x(i, j);
+      }
+    }
+    solves.Checkpoint(1.0);
+    return result;
+  });
+}
+
+std::future<double> S21Matrix::DeterminantAsync(
+    const S21TaskControl& control) const {
+  if (rows_ != cols_) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  return submitTask<double>([a = *this, control] {
+    double result = S21LU(a, control).Determinant();
+    control.Checkpoint(1.0);
+    return result;
+  });
 }
 
 S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
@@ -232,54 +1035,83 @@ S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
 }
 
 S21Matrix& S21Matrix::operator=(S21Matrix&& other) noexcept {
-  if (this != &other) {
-    if (matrix_) {
-      for (auto i = 0; i < rows_; i++) {
-        if (matrix_[i]) delete[] matrix_[i];
-      }
-      delete[] matrix_;
-    }
+  if (this != &other && other.isBorrowed()) {
+    // the buffer stays with its view, this gets its own elements
+    *this = S21Matrix(static_cast<const S21Matrix&>(other));
+  } else if (this != &other) {
+    releaseMatrix();
 
     rows_ = std::move(other.rows_);
     cols_ = std::move(other.cols_);
+    layout_ = other.layout_;
+    row_stride_ = other.row_stride_;
+    col_stride_ = other.col_stride_;
+    shared_ = other.shared_;
     matrix_ = std::exchange(other.matrix_, nullptr);
+    storage_ = std::exchange(other.storage_, nullptr);
   }
 
   return *this;
 }
 // index operator overload
-double& S21Matrix::operator()(int row, int col) const {
+double& S21Matrix::operator()(int row, int col) {
   if (row >= rows_ || col >= cols_ || row < 0 || col < 0)
     throw std::out_of_range("Incorrect input, index is out of range");
 
-  return matrix_[row][col];
+  detachMatrix();
+  return matrix_[offset(row, col)];
+}
+
+const double& S21Matrix::operator()(int row, int col) const {
+  if (row >= rows_ || col >= cols_ || row < 0 || col < 0)
+    throw std::out_of_range("Incorrect input, index is out of range");
+
+  return matrix_[offset(row, col)];
 }
 
 // operator + overload
-S21Matrix S21Matrix::operator+(const S21Matrix& other) const {
+S21Matrix S21Matrix::operator+(const S21Matrix& other) const& {
   S21Matrix result(*this);
   result.SumMatrix(other);
   return result;
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix& other) const {
+S21Matrix S21Matrix::operator+(const S21Matrix& other) && {
+  if (isBorrowed()) return static_cast<const S21Matrix&>(*this) + other;
+  SumMatrix(other);
+  return std::move(*this);
+}
+
+S21Matrix S21Matrix::operator-(const S21Matrix& other) const& {
   S21Matrix result(*this);
   result.SubMatrix(other);
   return result;
 }
 
+S21Matrix S21Matrix::operator-(const S21Matrix& other) && {
+  if (isBorrowed()) return static_cast<const S21Matrix&>(*this) - other;
+  SubMatrix(other);
+  return std::move(*this);
+}
+
 S21Matrix S21Matrix::operator*(const S21Matrix& other) const {
   S21Matrix result(*this);
   result.MulMatrix(other);
   return result;
 }
 
-S21Matrix S21Matrix::operator*(double num) const {
+S21Matrix S21Matrix::operator*(double num) const& {
   S21Matrix result(*this);
   result.MulNumber(num);
   return result;
 }
 
+S21Matrix S21Matrix::operator*(double num) && {
+  if (isBorrowed()) return static_cast<const S21Matrix&>(*this) * num;
+  MulNumber(num);
+  return std::move(*this);
+}
+
 bool S21Matrix::operator==(const S21Matrix& other) const noexcept {
   return EqMatrix(other);
 }
@@ -308,3 +1140,9 @@ S21Matrix operator*(const double& value, const S21Matrix& matrix) {
   S21Matrix res(matrix);
   return res *= value;
 }
+
+S21Matrix operator*(const double& value, S21Matrix&& matrix) {
+  if (matrix.isBorrowed()) return value * static_cast<const S21Matrix&>(matrix);
+  matrix.MulNumber(value);
+  return std::move(matrix);
+}
@@ -2,65 +2,341 @@
 #define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_MATRIX_OOP_H_
 
 #include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <utility>
 
+#include "s21_matrix/s21_numa.h"
+#include "s21_matrix/s21_task.h"
+
+// order of elements in memory, the stride is the distance between the
+// starts of consecutive rows (kRowMajor) or columns (kColMajor)
+enum class S21Layout { kRowMajor, kColMajor };
+
+// Matrix Market storage: every element column by column, or the nonzero
+// ones as (row, column, value) lines
+enum class S21MatrixMarketFormat { kArray, kCoordinate };
+
+// two elements match when any criterion holds: they are equal, their
+// difference is at most absolute, at most relative times the larger
+// magnitude, or they are at most ulps representable doubles apart
+struct S21EqualityPolicy {
+  double absolute = 1e-7;
+  double relative = 0.0;
+  std::int64_t ulps = 0;
+};
+
+// random maps that sketch a matrix: dense standard normal, or the
+// subsampled randomized Hadamard transform (random signs, a fast
+// Walsh-Hadamard transform and a random choice of columns)
+enum class S21SketchKind { kGaussian, kSrht };
+
+// parameters of the randomized low-rank methods, see S21LowRankMatrix
+struct S21RandomizedOptions {
+  // samples taken beyond the requested rank
+  int oversampling = 10;
+  // passes of A * A^T over the samples, each orthonormalized again; they
+  // sharpen the basis when the singular values decay slowly
+  int power_iterations = 1;
+  S21SketchKind sketch = S21SketchKind::kGaussian;
+  std::uint64_t seed = 0;
+};
+
+struct S21MatrixStats;
+class S21MatrixView;
+
 class S21Matrix {
  public:
+  // tag for constructing a matrix whose elements are left unset
+  struct Uninitialized {};
+  static constexpr Uninitialized uninitialized{};
+
+  enum class Distribution { kUniform, kNormal };
+
   // constructors and destructors
   S21Matrix() noexcept;
   S21Matrix(int rows, int cols);
+  S21Matrix(int rows, int cols, S21Layout layout);
+  // skips the zeroing pass, every element must be written before it is read
+  S21Matrix(int rows, int cols, Uninitialized);
+  // adopts data as the matrix storage without copying, stride 0 means
+  // packed; the matrix releases the buffer with delete[]
+  S21Matrix(std::unique_ptr<double[]> data, int rows, int cols,
+            S21Layout layout = S21Layout::kRowMajor, int stride = 0);
+  // shares ownership of data with the caller, the buffer lives until both
+  // sides have released it
+  S21Matrix(std::shared_ptr<double[]> data, int rows, int cols,
+            S21Layout layout = S21Layout::kRowMajor, int stride = 0);
+  // borrows data, which the caller keeps alive for the lifetime of the
+  // returned view; writes go to data, copies and matrices moved from the
+  // view always own their elements, and resizing the view throws
+  // std::logic_error
+  static S21MatrixView Wrap(double* data, int rows, int cols,
+                            S21Layout layout = S21Layout::kRowMajor,
+                            int stride = 0);
   S21Matrix(const S21Matrix& other);
+  // a borrowed source is copied, its buffer stays with the view
   S21Matrix(S21Matrix&& other) noexcept;
+  // a view cannot hand its borrowed buffer to an owning matrix
+  S21Matrix(S21MatrixView&& other) = delete;
   ~S21Matrix();
 
   // getters
   int GetRows() const noexcept;
   int GetCols() const noexcept;
+  S21Layout GetLayout() const noexcept;
+  int GetStride() const noexcept;
+  // whether the elements fill one gap-free block of rows * cols doubles
+  bool IsContiguous() const noexcept;
+  // first element, laid out as GetLayout() with GetStride(); the non-const
+  // overload detaches shared storage like any other write access
+  double* data();
+  const double* data() const noexcept;
   S21Matrix GetMinor(int rows, int cols) const;
 
   // setters
   void SetRows(int rows);
   void SetCols(int cols);
 
+  // copy-on-write sharing: when enabled, copies of this matrix share its
+  // storage and the first mutating access detaches a private buffer
+  void SetShared(bool shared) noexcept;
+  bool IsShared() const noexcept;
+  // number of matrices referencing the same storage
+  long UseCount() const noexcept;
+
+  // placement policy for buffers of at least S21Numa::kMinBytes allocated
+  // from now on, kDefault keeps the single-thread zeroing; the others also
+  // pin the pool workers to their nodes, kDefault leaves them unpinned
+  static void SetNumaPolicy(S21NumaPolicy policy) noexcept;
+  static S21NumaPolicy GetNumaPolicy() noexcept;
+
   // operators overloads
   // assignment operator overload
   S21Matrix& operator=(const S21Matrix& other);
   S21Matrix& operator=(S21Matrix&& other) noexcept;
+  S21Matrix& operator=(S21MatrixView&& other) = delete;
   // index operator overload
-  double& operator()(int row, int col) const;
-  S21Matrix operator+(const S21Matrix& other) const;
-  S21Matrix operator-(const S21Matrix& other) const;
+  double& operator()(int row, int col);
+  const double& operator()(int row, int col) const;
+  // rvalue overloads reuse the storage of the expiring left operand
+  S21Matrix operator+(const S21Matrix& other) const&;
+  S21Matrix operator+(const S21Matrix& other) &&;
+  S21Matrix operator-(const S21Matrix& other) const&;
+  S21Matrix operator-(const S21Matrix& other) &&;
   S21Matrix operator*(const S21Matrix& other) const;
-  S21Matrix operator*(double num) const;
+  S21Matrix operator*(double num) const&;
+  S21Matrix operator*(double num) &&;
   bool operator==(const S21Matrix& other) const noexcept;
   S21Matrix& operator+=(const S21Matrix& other);
   S21Matrix& operator-=(const S21Matrix& other);
   S21Matrix& operator*=(const S21Matrix& other);
   S21Matrix& operator*=(double num);
 
+  // builders, each element is written exactly once, large matrices in
+  // parallel on the thread pool
+  void Fill(double value);
+  static S21Matrix Identity(int size);
+  // uniform on [0, 1) or standard normal, the same seed gives the same
+  // matrix for any number of threads
+  static S21Matrix Random(int rows, int cols, std::uint64_t seed,
+                          Distribution distribution = Distribution::kUniform);
+  // element (i, j) is generator(i, j), called concurrently for large sizes
+  static S21Matrix FromGenerator(
+      int rows, int cols, const std::function<double(int, int)>& generator);
+
+  // text files; the readers map the file, split it into chunks of whole
+  // lines parsed in parallel with std::from_chars straight into the
+  // elements, and the writers format in parallel with std::to_chars, whose
+  // shortest representation reads back exactly. A file that cannot be
+  // opened throws std::runtime_error, malformed contents
+  // std::invalid_argument
+  // one row per line, blank lines are skipped
+  static S21Matrix FromCSV(const std::string& path, char delimiter = ',');
+  // real, integer or pattern; general, symmetric or skew-symmetric; array
+  // or coordinate, where missing elements are zero and an element must not
+  // be listed twice
+  static S21Matrix FromMatrixMarket(const std::string& path);
+  void ToCSV(const std::string& path, char delimiter = ',') const;
+  // real general
+  void ToMatrixMarket(
+      const std::string& path,
+      S21MatrixMarketFormat format = S21MatrixMarketFormat::kArray) const;
+
   // // some public methods
+  // matrices of different sizes are never equal
   bool EqMatrix(const S21Matrix& other) const noexcept;
+  bool EqMatrix(const S21Matrix& other,
+                const S21EqualityPolicy& policy) const noexcept;
   void SumMatrix(const S21Matrix& other);
   void SubMatrix(const S21Matrix& other);
-  void MulNumber(const double num) noexcept;
+  void MulNumber(const double num);
   void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose() const;
+  // O(1) for a shared matrix: the result shares the storage with the
+  // storage order flipped until either side is modified; otherwise one copy
+  // in storage order, flipped the same way
+  S21Matrix Transpose() const&;
+  S21Matrix Transpose() &&;
+  // copy with the requested storage order, packed
+  S21Matrix ToLayout(S21Layout layout) const;
   S21Matrix CalcComplements() const;
+  // the product of the diagonal for a triangular matrix, else through
+  // S21LU; 1 for a 0 x 0 matrix, the empty product, as S21LU and
+  // DeterminantAsync give
   double Determinant() const;
+  // through S21LU, throws std::logic_error when the estimated reciprocal
+  // condition number is below machine epsilon
   S21Matrix InverseMatrix() const;
+  // S21LU::Rcond of this matrix
+  double Rcond() const;
+  // S21LU::IsSingular of this matrix, whether Rcond() is below tolerance
+  bool IsSingular(double tolerance) const;
+  // number of pivots above tolerance in elimination with complete pivoting;
+  // the default tolerance is max(rows, cols) * eps * the largest element
+  int Rank() const;
+  int Rank(double tolerance) const;
+  // A^power by repeated squaring, O(n^3 log |power|) with three buffers
+  // reused across the squarings; negative powers invert first
+  S21Matrix Pow(int power) const;
+  // matrix exponential, [13/13] Pade approximant with scaling and squaring
+  S21Matrix Exp() const;
+  // rows x size matrix with orthonormal columns whose range approximately
+  // contains the range of this matrix: the range of a random sketch,
+  // sharpened by the power iterations of options (Halko, Martinsson and
+  // Tropp, algorithm 4.4), O(rows * cols * size); size is capped at
+  // min(rows, cols) and the columns of directions the matrix does not have
+  // come out zero. Throws std::invalid_argument for a size below 1 or
+  // negative options
+  S21Matrix RangeFinder(
+      int size,
+      const S21RandomizedOptions& options = S21RandomizedOptions()) const;
+
+  // reductions, each one parallel pass over the elements in storage order,
+  // summed in blocks of independent Kahan lanes whose block sums are
+  // compensated (Neumaier); a NaN element makes the min, max and norms NaN.
+  // Stats() gathers everything in one pass, the others compute only their
+  // own value
+  S21MatrixStats Stats() const;
+  double Sum() const;
+  double Mean() const;
+  double Min() const;
+  double Max() const;
+  double FrobeniusNorm() const;
+  // largest absolute column sum
+  double Norm1() const;
+  // largest absolute row sum
+  double NormInf() const;
+  // reads only the diagonal, throws std::logic_error for a non-square matrix
+  double Trace() const;
+  // rows x 1 and 1 x cols
+  S21Matrix RowSums() const;
+  S21Matrix ColSums() const;
+
+  // asynchronous versions on the thread pool coordinators, see
+  // S21ThreadPool::Submit; the operands are copied, so they may change or
+  // go away right after the call; size errors throw here, calculation
+  // errors and S21Cancelled come out of the future
+  // this * other, computed in row panels with a checkpoint between them
+  std::future<S21Matrix> MulMatrixAsync(
+      const S21Matrix& other,
+      const S21TaskControl& control = S21TaskControl()) const;
+  // with the same singularity check as InverseMatrix
+  std::future<S21Matrix> InverseMatrixAsync(
+      const S21TaskControl& control = S21TaskControl()) const;
+  std::future<double> DeterminantAsync(
+      const S21TaskControl& control = S21TaskControl()) const;
 
   // friend function
   friend S21Matrix operator*(const double& value, const S21Matrix& matrix);
+  friend S21Matrix operator*(const double& value, S21Matrix&& matrix);
+  friend struct S21MatrixHash;
+  friend class S21MatrixView;
 
  private:
+  // reference-counted buffer shared between copy-on-write copies
+  struct Storage;
+
   // attributes
   // rows and columns attributes
   int rows_, cols_;
-  // pointer to the memory where the matrix will be allocated
-  double** matrix_;
-  void createMatrix();
+  // element (row, col) is matrix_[row * row_stride_ + col * col_stride_]
+  double* matrix_;
+  Storage* storage_;
+  S21Layout layout_;
+  int row_stride_, col_stride_;
+  // whether copies may share storage_ instead of duplicating it
+  bool shared_;
+  void createMatrix(bool zeroed = true,
+                    S21Layout layout = S21Layout::kRowMajor);
+  void releaseMatrix() noexcept;
+  // gives this matrix a private buffer before it is modified
+  void detachMatrix();
+  void adoptStorage(Storage* storage, S21Layout layout, int stride);
+  // references the storage of other as a copy-on-write view
+  void shareStorage(const S21Matrix& other) noexcept;
+  long offset(int row, int col) const noexcept;
+  bool isBorrowed() const noexcept;
+  // throws std::logic_error when a borrowed matrix would change its size
+  void checkResize(int rows, int cols) const;
+  // takes the elements of result, copying them into borrowed storage
+  void replaceWith(S21Matrix&& result);
+  // whether both matrices are contiguous with the same layout, so their
+  // elements correspond one to one in memory order
+  bool sameOrder(const S21Matrix& other) const noexcept;
+  // copies the elements of other, which has the same size
+  void copyElements(const S21Matrix& other);
+  // this = a * b, reusing the storage of this when it is private, of the
+  // right shape and not an operand
+  void assignProduct(const S21Matrix& a, const S21Matrix& b);
+  // calls body(i, j) for every element in the storage order of this matrix
+  template <class Body>
+  void forEachIndex(Body body) const;
+  // element-wise kernels that walk memory sequentially when they can
+  template <class Op>
+  void forEachElement(Op op);
+  template <class Op>
+  void zipWith(const S21Matrix& other, Op op);
+};
+
+// matrix over a buffer owned by the caller, see S21Matrix::Wrap; it cannot
+// be copied, moved or assigned, so the borrow ends with the view. Copies
+// taken as S21Matrix own their elements
+class S21MatrixView : public S21Matrix {
+ public:
+  S21MatrixView(const S21MatrixView&) = delete;
+  S21MatrixView(S21MatrixView&&) = delete;
+  S21MatrixView& operator=(const S21MatrixView&) = delete;
+  S21MatrixView& operator=(S21MatrixView&&) = delete;
+
+ private:
+  friend class S21Matrix;
+  S21MatrixView(double* data, int rows, int cols, S21Layout layout,
+                int stride);
+};
+
+// everything Stats() gathers; the mean of an empty matrix is NaN, its
+// minimum +inf and maximum -inf; trace sums the main diagonal, also of a
+// non-square matrix
+struct S21MatrixStats {
+  double sum, mean, min, max;
+  double frobenius, norm1, norm_inf, trace;
+  S21Matrix row_sums, col_sums;
+};
+
+// hash over the size and the bits of the elements in row order, the same for
+// any layout; pair it with S21MatrixExactEqual, since tolerant equality is
+// not transitive and no hash can agree with it
+struct S21MatrixHash {
+  std::size_t operator()(const S21Matrix& matrix) const noexcept;
+};
+
+struct S21MatrixExactEqual {
+  bool operator()(const S21Matrix& a, const S21Matrix& b) const noexcept;
 };
 
 #endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_MATRIX_OOP_H_
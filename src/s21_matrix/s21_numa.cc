@@ -0,0 +1,111 @@
+#include "s21_matrix/s21_numa.h"
+
+#include <new>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+// from <linux/mempolicy.h>, not every libc ships it
+constexpr int kMpolInterleave = 3;
+
+// parses sysfs lists like "0-3,8,10-11"
+std::vector<int> readList(const char* path) {
+  std::vector<int> result;
+  std::FILE* file = std::fopen(path, "r");
+  if (!file) return result;
+  int first = 0;
+  while (std::fscanf(file, "%d", &first) == 1) {
+    int last = first;
+    int separator = std::fgetc(file);
+    if (separator == '-') {
+      if (std::fscanf(file, "%d", &last) != 1) break;
+      separator = std::fgetc(file);
+    }
+    for (auto i = first; i <= last; i++) result.push_back(i);
+    if (separator != ',') break;
+  }
+  std::fclose(file);
+  return result;
+}
+
+// the affinity of this thread before it was first bound
+thread_local bool saved = false;
+thread_local cpu_set_t unbound;
+
+const std::vector<int>& onlineNodes() {
+  static const std::vector<int> nodes =
+      readList("/sys/devices/system/node/online");
+  return nodes;
+}
+}  // namespace
+
+int S21Numa::NodeCount() noexcept {
+  const std::vector<int>& nodes = onlineNodes();
+  return nodes.empty() ? 1 : static_cast<int>(nodes.size());
+}
+
+bool S21Numa::BindCurrentThread(int node) noexcept {
+  if (NodeCount() <= 1 || node < 0 || node >= NodeCount()) return false;
+  char path[64];
+  std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+                onlineNodes()[node]);
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : readList(path)) {
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+  }
+  if (CPU_COUNT(&set) == 0) return false;
+  if (!saved) saved = sched_getaffinity(0, sizeof(unbound), &unbound) == 0;
+  return saved && sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool S21Numa::UnbindCurrentThread() noexcept {
+  return saved && sched_setaffinity(0, sizeof(unbound), &unbound) == 0;
+}
+
+void* S21Numa::AllocatePages(std::size_t bytes) {
+  void* pages = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (pages == MAP_FAILED) throw std::bad_alloc();
+  return pages;
+}
+
+void S21Numa::FreePages(void* pages, std::size_t bytes) noexcept {
+  if (pages) munmap(pages, bytes);
+}
+
+bool S21Numa::Interleave(void* pages, std::size_t bytes) noexcept {
+  if (NodeCount() <= 1) return false;
+  constexpr std::size_t kBits = 8 * sizeof(unsigned long);
+  unsigned long mask[16] = {};
+  for (int node : onlineNodes()) {
+    if (node < static_cast<int>(16 * kBits)) {
+      mask[node / kBits] |= 1UL << (node % kBits);
+    }
+  }
+  return syscall(SYS_mbind, pages, bytes, kMpolInterleave, mask,
+                 16 * kBits + 1, 0) == 0;
+}
+
+#else
+
+int S21Numa::NodeCount() noexcept { return 1; }
+
+bool S21Numa::BindCurrentThread(int) noexcept { return false; }
+
+bool S21Numa::UnbindCurrentThread() noexcept { return false; }
+
+void* S21Numa::AllocatePages(std::size_t) { return nullptr; }
+
+void S21Numa::FreePages(void*, std::size_t) noexcept {}
+
+bool S21Numa::Interleave(void*, std::size_t) noexcept { return false; }
+
+#endif
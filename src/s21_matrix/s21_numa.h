@@ -0,0 +1,36 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_NUMA_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_NUMA_H_
+
+#include <cstddef>
+
+// placement of large matrix buffers on multi-socket machines
+enum class S21NumaPolicy {
+  // zero-initialized by the constructing thread
+  kDefault,
+  // pages spread round-robin over all memory nodes
+  kInterleave,
+  // pages first touched by the pool worker owning each block of rows
+  kFirstTouch
+};
+
+// thin wrapper over the Linux NUMA syscalls, every call degrades to a no-op
+// on single-node machines and on other platforms
+class S21Numa {
+ public:
+  // buffers smaller than this ignore the policy
+  static constexpr std::size_t kMinBytes = 1 << 20;
+
+  static int NodeCount() noexcept;
+  // restricts the calling thread to the cpus of node
+  static bool BindCurrentThread(int node) noexcept;
+  // gives the calling thread back the cpus it had before its first bind
+  static bool UnbindCurrentThread() noexcept;
+  // page-aligned zeroed memory that is not touched yet, or nullptr when
+  // the platform has no anonymous mappings
+  static void* AllocatePages(std::size_t bytes);
+  static void FreePages(void* pages, std::size_t bytes) noexcept;
+  // sets an interleaved memory policy on untouched pages
+  static bool Interleave(void* pages, std::size_t bytes) noexcept;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_NUMA_H_
@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix/s21_matrix_oop.h"
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+// independent accumulators per kernel, enough to fill the vector units;
+// each carries a branch-free Kahan correction, and the sums of every block
+// of kChunk elements are compensated against each other with Neumaier's
+// method, which also covers terms larger than the running sum
+constexpr int kLanes = 4;
+constexpr int kChunk = 256;
+
+// Neumaier's compensated sum, the rounding error of every addition is
+// carried separately and added back at the end
+struct Compensated {
+  double sum = 0.0;
+  double carry = 0.0;
+
+  void Add(double x) noexcept {
+    double total = sum + x;
+    carry += std::fabs(sum) >= std::fabs(x) ? (sum - total) + x
+                                            : (x - total) + sum;
+    sum = total;
+  }
+  void Add(const Compensated& other) noexcept {
+    Add(other.sum);
+    carry += other.carry;
+  }
+  double Value() const noexcept { return sum + carry; }
+};
+
+// the terms the sums add up
+struct Plain {
+  double operator()(double x) const noexcept { return x; }
+};
+struct Absolute {
+  double operator()(double x) const noexcept { return std::fabs(x); }
+};
+struct Square {
+  double operator()(double x) const noexcept { return x * x; }
+};
+
+// Kahan step, carry keeps minus what the addition lost
+inline void kahanAdd(double& sum, double& carry, double x) noexcept {
+  double y = x - carry;
+  double total = sum + y;
+  carry = (total - sum) - y;
+  sum = total;
+}
+
+// sum of term(x[k]) for k < n in kLanes interleaved Kahan accumulators;
+// the lanes do not depend on each other, so the loop vectorizes
+template <class Term>
+Compensated laneSum(const double* x, int n, Term term) noexcept {
+  double sums[kLanes] = {}, carries[kLanes] = {};
+  int k = 0;
+  for (; k + kLanes <= n; k += kLanes) {
+    for (auto l = 0; l < kLanes; l++) {
+      kahanAdd(sums[l], carries[l], term(x[k + l]));
+    }
+  }
+  for (; k < n; k++) kahanAdd(sums[0], carries[0], term(x[k]));
+  Compensated result;
+  for (auto l = 0; l < kLanes; l++) {
+    result.Add(sums[l]);
+    result.carry -= carries[l];
+  }
+  return result;
+}
+
+// sum of term over the n elements of a line, block by block
+template <class Term>
+Compensated lineSum(const double* x, int n, Term term) noexcept {
+  Compensated sum;
+  for (auto begin = 0; begin < n; begin += kChunk) {
+    sum.Add(laneSum(x + begin, std::min(kChunk, n - begin), term));
+  }
+  return sum;
+}
+
+// smallest and largest element, both NaN once any element is NaN
+struct Extrema {
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  bool unordered = false;
+
+  void Scan(const double* x, int n) noexcept {
+    // the NaN flags are doubles as well, so the lanes share vectors
+    double low[kLanes], high[kLanes], nan[kLanes] = {};
+    for (auto l = 0; l < kLanes; l++) {
+      low[l] = min;
+      high[l] = max;
+    }
+    int k = 0;
+    for (; k + kLanes <= n; k += kLanes) {
+      for (auto l = 0; l < kLanes; l++) {
+        double value = x[k + l];
+        low[l] = value < low[l] ? value : low[l];
+        high[l] = value > high[l] ? value : high[l];
+        nan[l] = value != value ? 1.0 : nan[l];
+      }
+    }
+    for (; k < n; k++) {
+      low[0] = x[k] < low[0] ? x[k] : low[0];
+      high[0] = x[k] > high[0] ? x[k] : high[0];
+      nan[0] = x[k] != x[k] ? 1.0 : nan[0];
+    }
+    for (auto l = 0; l < kLanes; l++) {
+      min = std::min(min, low[l]);
+      max = std::max(max, high[l]);
+      unordered = unordered || nan[l] != 0.0;
+    }
+  }
+  void Add(const Extrema& other) noexcept {
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    unordered = unordered || other.unordered;
+  }
+  double Min() const noexcept {
+    return unordered ? std::numeric_limits<double>::quiet_NaN() : min;
+  }
+  double Max() const noexcept {
+    return unordered ? std::numeric_limits<double>::quiet_NaN() : max;
+  }
+};
+
+// sums across lines, per position inside a line: blocks of kChunk lines
+// go into Kahan sums position by position, then into the compensated ones
+struct Across {
+  std::vector<double> pending, carries;
+  std::vector<Compensated> sums;
+  int count = 0;
+
+  explicit Across(int length)
+      : pending(length), carries(length), sums(length) {}
+  template <class Term>
+  void Add(const double* x, Term term) noexcept {
+    const auto length = pending.size();
+    double* sum = pending.data();
+    double* carry = carries.data();
+    std::size_t k = 0;
+    for (; k + kLanes <= length; k += kLanes) {
+      double terms[kLanes];
+      for (auto l = 0; l < kLanes; l++) terms[l] = term(x[k + l]);
+      for (auto l = 0; l < kLanes; l++) {
+        kahanAdd(sum[k + l], carry[k + l], terms[l]);
+      }
+    }
+    for (; k < length; k++) kahanAdd(sum[k], carry[k], term(x[k]));
+    if (++count == kChunk) {
+      for (k = 0; k < length; k++) {
+        flush(sums[k], pending[k], carries[k]);
+        pending[k] = carries[k] = 0.0;
+      }
+      count = 0;
+    }
+  }
+  // adds what other holds, pending included
+  void Merge(const Across& other) noexcept {
+    for (std::size_t k = 0; k < sums.size(); k++) {
+      sums[k].Add(other.sums[k]);
+      flush(sums[k], other.pending[k], other.carries[k]);
+    }
+  }
+  static void flush(Compensated& into, double sum, double carry) noexcept {
+    into.Add(sum);
+    into.carry -= carry;
+  }
+};
+
+// largest of values, 0 for none and NaN if one of them is NaN
+double largest(const std::vector<double>& values) noexcept {
+  double result = 0.0;
+  for (double value : values) {
+    if (std::isnan(value)) return value;
+    result = std::max(result, value);
+  }
+  return result;
+}
+
+// what a block of lines contributes, lines being the rows of a row-major
+// matrix and the columns of a column-major one
+struct Partial {
+  explicit Partial(int length) : across(length), across_abs(length) {}
+
+  long begin = 0;
+  Compensated sum, squares, trace;
+  Extrema extrema;
+  Across across, across_abs;
+};
+
+// the elements as lines of length doubles stride apart, the rows of a
+// row-major matrix and the columns of a column-major one
+struct Lines {
+  const double* data;
+  int count, length;
+  long stride;
+  bool row_major;
+};
+
+Lines linesOf(const S21Matrix& matrix) {
+  const bool row_major = matrix.GetLayout() == S21Layout::kRowMajor;
+  return {matrix.data(), row_major ? matrix.GetRows() : matrix.GetCols(),
+          row_major ? matrix.GetCols() : matrix.GetRows(), matrix.GetStride(),
+          row_major};
+}
+
+// folds the lines of every block into a copy of state with
+// fold(partial, values), then merges the blocks into state in index order
+// whichever finished first, so the result does not depend on the timing
+template <class State, class Fold, class Merge>
+State reduceLines(const Lines& lines, State state, Fold fold, Merge merge) {
+  std::vector<std::pair<long, State>> partials;
+  std::mutex mutex;
+  S21ThreadPool::ParallelRows(
+      lines.count, lines.length, [&](long begin, long end) {
+        State partial = state;
+        for (auto line = begin; line < end; line++) {
+          fold(partial, lines.data + line * lines.stride);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        partials.emplace_back(begin, std::move(partial));
+      });
+  std::sort(partials.begin(), partials.end(),
+            [](const std::pair<long, State>& a,
+               const std::pair<long, State>& b) { return a.first < b.first; });
+  for (const auto& partial : partials) merge(state, partial.second);
+  return state;
+}
+
+// sums of term over the rows (by_rows) or the columns; along a line when
+// that is the storage order, else across the lines
+template <class Term>
+std::vector<double> sums(const S21Matrix& matrix, bool by_rows, Term term) {
+  const Lines lines = linesOf(matrix);
+  if (lines.row_major == by_rows) {
+    std::vector<double> result(lines.count);
+    S21ThreadPool::ParallelRows(
+        lines.count, lines.length, [&](long begin, long end) {
+          for (auto line = begin; line < end; line++) {
+            result[line] =
+                lineSum(lines.data + line * lines.stride, lines.length, term)
+                    .Value();
+          }
+        });
+    return result;
+  }
+  Across across = reduceLines(
+      lines, Across(lines.length),
+      [&](Across& partial, const double* values) {
+        partial.Add(values, term);
+      },
+      [](Across& all, const Across& partial) { all.Merge(partial); });
+  std::vector<double> result(lines.length);
+  for (auto k = 0; k < lines.length; k++) result[k] = across.sums[k].Value();
+  return result;
+}
+
+// rows x 1 for by_rows, else 1 x cols
+S21Matrix sumsMatrix(const S21Matrix& matrix, bool by_rows) {
+  std::vector<double> values = sums(matrix, by_rows, Plain());
+  S21Matrix result(by_rows ? matrix.GetRows() : 1,
+                   by_rows ? 1 : matrix.GetCols(), S21Matrix::uninitialized);
+  std::copy(values.begin(), values.end(), result.data());
+  return result;
+}
+
+// sum of term over all elements, added in the order Stats() adds them
+template <class Term>
+double total(const S21Matrix& matrix, Term term) {
+  const Lines lines = linesOf(matrix);
+  return reduceLines(
+             lines, Compensated(),
+             [&](Compensated& partial, const double* values) {
+               partial.Add(lineSum(values, lines.length, term));
+             },
+             [](Compensated& all, const Compensated& partial) {
+               all.Add(partial);
+             })
+      .Value();
+}
+
+Extrema extrema(const S21Matrix& matrix) {
+  const Lines lines = linesOf(matrix);
+  return reduceLines(
+      lines, Extrema(),
+      [&](Extrema& partial, const double* values) {
+        partial.Scan(values, lines.length);
+      },
+      [](Extrema& all, const Extrema& partial) { all.Add(partial); });
+}
+}  // namespace
+
+S21MatrixStats S21Matrix::Stats() const {
+  const bool row_major = layout_ == S21Layout::kRowMajor;
+  const int lines = row_major ? rows_ : cols_;
+  const int length = row_major ? cols_ : rows_;
+  const long stride = GetStride();
+  const int diagonal = std::min(rows_, cols_);
+  std::vector<double> line_sums(lines), line_abs(lines);
+  std::vector<Partial> partials;
+  std::mutex mutex;
+
+  // every kernel below reads a line that is still in cache
+  S21ThreadPool::ParallelRows(lines, length, [&](long begin, long end) {
+    Partial partial(length);
+    partial.begin = begin;
+    for (auto line = begin; line < end; line++) {
+      const double* values = matrix_ + line * stride;
+      Compensated sum = lineSum(values, length, Plain());
+      partial.squares.Add(lineSum(values, length, Square()));
+      partial.extrema.Scan(values, length);
+      partial.across.Add(values, Plain());
+      partial.across_abs.Add(values, Absolute());
+      if (line < diagonal) partial.trace.Add(values[line]);
+      partial.sum.Add(sum);
+      line_sums[line] = sum.Value();
+      line_abs[line] = lineSum(values, length, Absolute()).Value();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    partials.push_back(std::move(partial));
+  });
+
+  // blocks combine in index order whichever finished first
+  std::sort(partials.begin(), partials.end(),
+            [](const Partial& a, const Partial& b) {
+              return a.begin < b.begin;
+            });
+  Partial total(length);
+  for (const auto& partial : partials) {
+    total.sum.Add(partial.sum);
+    total.squares.Add(partial.squares);
+    total.trace.Add(partial.trace);
+    total.extrema.Add(partial.extrema);
+    total.across.Merge(partial.across);
+    total.across_abs.Merge(partial.across_abs);
+  }
+
+  S21MatrixStats stats{total.sum.Value(),
+                       total.sum.Value() / (static_cast<double>(rows_) * cols_),
+                       total.extrema.Min(),
+                       total.extrema.Max(),
+                       std::sqrt(total.squares.Value()),
+                       0.0,
+                       0.0,
+                       total.trace.Value(),
+                       S21Matrix(rows_, 1, uninitialized),
+                       S21Matrix(1, cols_, uninitialized)};
+  double* row_sums = stats.row_sums.data();
+  double* col_sums = stats.col_sums.data();
+  std::vector<double> across_abs(length);
+  for (auto line = 0; line < lines; line++) {
+    (row_major ? row_sums : col_sums)[line] = line_sums[line];
+  }
+  for (auto k = 0; k < length; k++) {
+    (row_major ? col_sums : row_sums)[k] = total.across.sums[k].Value();
+    across_abs[k] = total.across_abs.sums[k].Value();
+  }
+  stats.norm1 = largest(row_major ? across_abs : line_abs);
+  stats.norm_inf = largest(row_major ? line_abs : across_abs);
+  return stats;
+}
+
+double S21Matrix::Sum() const { return total(*this, Plain()); }
+
+double S21Matrix::Mean() const {
+  return Sum() / (static_cast<double>(rows_) * cols_);
+}
+
+double S21Matrix::Min() const { return extrema(*this).Min(); }
+
+double S21Matrix::Max() const { return extrema(*this).Max(); }
+
+double S21Matrix::FrobeniusNorm() const {
+  return std::sqrt(total(*this, Square()));
+}
+
+double S21Matrix::Norm1() const {
+  return largest(sums(*this, false, Absolute()));
+}
+
+double S21Matrix::NormInf() const {
+  return largest(sums(*this, true, Absolute()));
+}
+
+S21Matrix S21Matrix::RowSums() const { return sumsMatrix(*this, true); }
+
+S21Matrix S21Matrix::ColSums() const { return sumsMatrix(*this, false); }
+
+double S21Matrix::Trace() const {
+  if (rows_ != cols_) {
+    throw std::logic_error("The matrix is not square.");
+  }
+  Compensated trace;
+  for (auto i = 0; i < rows_; i++) trace.Add(matrix_[offset(i, i)]);
+  return trace.Value();
+}
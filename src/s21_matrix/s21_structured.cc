@@ -0,0 +1,420 @@
+#include "s21_matrix/s21_structured.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+#include "s21_matrix/s21_thread_pool.h"
+
+namespace {
+void checkSize(int size) {
+  if (size < 0) {
+    throw std::invalid_argument("Rows and columns must be positive");
+  }
+}
+
+void checkIndex(int size, int row, int col) {
+  if (row >= size || col >= size || row < 0 || col < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range");
+  }
+}
+
+void checkSquare(const S21Matrix& matrix) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    throw std::logic_error("The matrix is not square.");
+  }
+}
+
+void checkProduct(int size, const S21Matrix& other) {
+  if (other.GetRows() != size) {
+    throw std::logic_error(
+        "Incorrect input, the number of inputed rows must be equal to the "
+        "number of columns of the first matrix.");
+  }
+}
+}  // namespace
+
+// symmetric
+
+S21SymmetricMatrix::S21SymmetricMatrix(int size)
+    : size_((checkSize(size), size)),
+      packed_(static_cast<std::size_t>(size) * (size + 1) / 2) {}
+
+S21SymmetricMatrix S21SymmetricMatrix::FromDense(const S21Matrix& matrix) {
+  checkSquare(matrix);
+  S21SymmetricMatrix result(matrix.GetRows());
+  for (auto i = 0; i < result.size_; i++) {
+    for (auto j = 0; j <= i; j++) {
+      result.packed_[result.index(i, j)] = matrix(i, j);
+    }
+  }
+  return result;
+}
+
+S21SymmetricMatrix S21SymmetricMatrix::Syrk(const S21Matrix& a,
+                                            double alpha) {
+  const int n = a.GetRows();
+  const int k = a.GetCols();
+  const S21Matrix rows = a.ToLayout(S21Layout::kRowMajor);
+  const double* data = rows.data();
+  S21SymmetricMatrix result(n);
+  double* packed = result.packed_.data();
+  // only the lower triangle: dot products of row i with rows 0..i
+  S21ThreadPool::ParallelRows(
+      n, static_cast<long>(n) * k / 2, [&](long begin, long end) {
+        for (auto i = begin; i < end; i++) {
+          const double* row_i = data + i * k;
+          double* out = packed + i * (i + 1) / 2;
+          for (auto j = 0; j <= i; j++) {
+            const double* row_j = data + j * k;
+            double sum = 0.0;
+            for (auto l = 0; l < k; l++) sum += row_i[l] * row_j[l];
+            out[j] = alpha * sum;
+          }
+        }
+      });
+  return result;
+}
+
+int S21SymmetricMatrix::GetSize() const noexcept { return size_; }
+
+std::size_t S21SymmetricMatrix::index(int row, int col) const {
+  checkIndex(size_, row, col);
+  if (row < col) std::swap(row, col);
+  return static_cast<std::size_t>(row) * (row + 1) / 2 + col;
+}
+
+double& S21SymmetricMatrix::operator()(int row, int col) {
+  return packed_[index(row, col)];
+}
+
+double S21SymmetricMatrix::operator()(int row, int col) const {
+  return packed_[index(row, col)];
+}
+
+S21Matrix S21SymmetricMatrix::ToDense() const {
+  return S21Matrix::FromGenerator(size_, size_, [this](int i, int j) {
+    return packed_[index(i, j)];
+  });
+}
+
+S21Matrix S21SymmetricMatrix::Multiply(const S21Matrix& other) const {
+  checkProduct(size_, other);
+  const int n = size_;
+  const int m = other.GetCols();
+  const S21Matrix b = other.ToLayout(S21Layout::kRowMajor);
+  const double* b_data = b.data();
+  const double* packed = packed_.data();
+  S21Matrix result(n, m);
+  double* c = result.data();
+  // row i of S is row i of the packed triangle up to the diagonal and
+  // column i of it below, so every output row is independent
+  S21ThreadPool::ParallelRows(
+      n, static_cast<long>(n) * m, [&](long begin, long end) {
+        for (auto i = begin; i < end; i++) {
+          double* c_row = c + i * m;
+          for (auto k = 0L; k < n; k++) {
+            double s = k <= i ? packed[i * (i + 1) / 2 + k]
+                              : packed[k * (k + 1) / 2 + i];
+            const double* b_row = b_data + k * m;
+            for (auto j = 0; j < m; j++) c_row[j] += s * b_row[j];
+          }
+        }
+      });
+  return result;
+}
+
+// triangular
+
+S21TriangularMatrix::S21TriangularMatrix(int size, S21Triangle triangle)
+    : size_((checkSize(size), size)),
+      triangle_(triangle),
+      packed_(static_cast<std::size_t>(size) * (size + 1) / 2) {}
+
+S21TriangularMatrix S21TriangularMatrix::FromDense(const S21Matrix& matrix,
+                                                   S21Triangle triangle) {
+  checkSquare(matrix);
+  S21TriangularMatrix result(matrix.GetRows(), triangle);
+  for (auto i = 0; i < result.size_; i++) {
+    for (auto j = 0; j < result.size_; j++) {
+      if (result.contains(i, j)) {
+        result.packed_[result.index(i, j)] = matrix(i, j);
+      }
+    }
+  }
+  return result;
+}
+
+int S21TriangularMatrix::GetSize() const noexcept { return size_; }
+
+S21Triangle S21TriangularMatrix::GetTriangle() const noexcept {
+  return triangle_;
+}
+
+bool S21TriangularMatrix::contains(int row, int col) const noexcept {
+  return triangle_ == S21Triangle::kLower ? col <= row : col >= row;
+}
+
+std::size_t S21TriangularMatrix::index(int row, int col) const noexcept {
+  std::size_t i = row;
+  if (triangle_ == S21Triangle::kLower) return i * (i + 1) / 2 + col;
+  // rows of the upper triangle shrink: row i starts after n + ... + n-i+1
+  return i * (2 * size_ - i + 1) / 2 + (col - row);
+}
+
+double& S21TriangularMatrix::operator()(int row, int col) {
+  checkIndex(size_, row, col);
+  if (!contains(row, col)) {
+    throw std::out_of_range("Incorrect input, index is outside the triangle");
+  }
+  return packed_[index(row, col)];
+}
+
+double S21TriangularMatrix::operator()(int row, int col) const {
+  checkIndex(size_, row, col);
+  return contains(row, col) ? packed_[index(row, col)] : 0.0;
+}
+
+S21Matrix S21TriangularMatrix::ToDense() const {
+  return S21Matrix::FromGenerator(
+      size_, size_, [this](int i, int j) { return (*this)(i, j); });
+}
+
+double S21TriangularMatrix::Determinant() const noexcept {
+  double result = 1.0;
+  for (auto i = 0; i < size_; i++) result *= packed_[index(i, i)];
+  return result;
+}
+
+S21Matrix S21TriangularMatrix::Multiply(const S21Matrix& other) const {
+  checkProduct(size_, other);
+  const int n = size_;
+  const int m = other.GetCols();
+  const S21Matrix b = other.ToLayout(S21Layout::kRowMajor);
+  const double* b_data = b.data();
+  S21Matrix result(n, m);
+  double* c = result.data();
+  const bool lower = triangle_ == S21Triangle::kLower;
+  S21ThreadPool::ParallelRows(
+      n, static_cast<long>(n) * m / 2, [&](long begin, long end) {
+        for (auto i = static_cast<int>(begin); i < end; i++) {
+          double* c_row = c + static_cast<long>(i) * m;
+          const double* t_row = packed_.data() + index(i, lower ? 0 : i);
+          int first = lower ? 0 : i;
+          int last = lower ? i : n - 1;
+          for (auto k = first; k <= last; k++) {
+            double t = t_row[k - first];
+            const double* b_row = b_data + static_cast<long>(k) * m;
+            for (auto j = 0; j < m; j++) c_row[j] += t * b_row[j];
+          }
+        }
+      });
+  return result;
+}
+
+S21Matrix S21TriangularMatrix::Solve(const S21Matrix& rhs) const {
+  checkProduct(size_, rhs);
+  const int n = size_;
+  const int m = rhs.GetCols();
+  S21Matrix result = rhs.ToLayout(S21Layout::kRowMajor);
+  double* x = result.data();
+  const bool lower = triangle_ == S21Triangle::kLower;
+  // substitution row by row, each step an axpy over whole rows of X
+  for (auto step = 0; step < n; step++) {
+    int i = lower ? step : n - 1 - step;
+    double diagonal = packed_[index(i, i)];
+    if (diagonal == 0.0) throw std::logic_error("The matrix is singular.");
+    double* x_row = x + static_cast<long>(i) * m;
+    int first = lower ? 0 : i + 1;
+    int last = lower ? i - 1 : n - 1;
+    for (auto k = first; k <= last; k++) {
+      double t = packed_[index(i, k)];
+      const double* x_k = x + static_cast<long>(k) * m;
+      for (auto j = 0; j < m; j++) x_row[j] -= t * x_k[j];
+    }
+    for (auto j = 0; j < m; j++) x_row[j] /= diagonal;
+  }
+  return result;
+}
+
+// band
+
+S21BandMatrix::S21BandMatrix(int size, int lower, int upper)
+    : size_((checkSize(size), size)),
+      lower_(lower),
+      upper_(upper) {
+  if (lower < 0 || upper < 0) {
+    throw std::invalid_argument("Bandwidths must not be negative");
+  }
+  band_.resize(static_cast<std::size_t>(size) * (lower + upper + 1));
+}
+
+S21BandMatrix S21BandMatrix::FromDense(const S21Matrix& matrix, int lower,
+                                       int upper) {
+  checkSquare(matrix);
+  S21BandMatrix result(matrix.GetRows(), lower, upper);
+  for (auto i = 0; i < result.size_; i++) {
+    int first = std::max(0, i - lower);
+    int last = std::min(result.size_ - 1, i + upper);
+    for (auto j = first; j <= last; j++) result(i, j) = matrix(i, j);
+  }
+  return result;
+}
+
+int S21BandMatrix::GetSize() const noexcept { return size_; }
+
+int S21BandMatrix::GetLower() const noexcept { return lower_; }
+
+int S21BandMatrix::GetUpper() const noexcept { return upper_; }
+
+bool S21BandMatrix::contains(int row, int col) const noexcept {
+  return col - row <= upper_ && row - col <= lower_;
+}
+
+double& S21BandMatrix::operator()(int row, int col) {
+  checkIndex(size_, row, col);
+  if (!contains(row, col)) {
+    throw std::out_of_range("Incorrect input, index is outside the band");
+  }
+  return band_[static_cast<std::size_t>(row) * (lower_ + upper_ + 1) +
+               (col - row + lower_)];
+}
+
+double S21BandMatrix::operator()(int row, int col) const {
+  checkIndex(size_, row, col);
+  if (!contains(row, col)) return 0.0;
+  return band_[static_cast<std::size_t>(row) * (lower_ + upper_ + 1) +
+               (col - row + lower_)];
+}
+
+S21Matrix S21BandMatrix::ToDense() const {
+  return S21Matrix::FromGenerator(
+      size_, size_, [this](int i, int j) { return (*this)(i, j); });
+}
+
+S21Matrix S21BandMatrix::Multiply(const S21Matrix& other) const {
+  checkProduct(size_, other);
+  const int n = size_;
+  const int m = other.GetCols();
+  const int width = lower_ + upper_ + 1;
+  const S21Matrix b = other.ToLayout(S21Layout::kRowMajor);
+  const double* b_data = b.data();
+  S21Matrix result(n, m);
+  double* c = result.data();
+  S21ThreadPool::ParallelRows(
+      n, static_cast<long>(width) * m, [&](long begin, long end) {
+        for (auto i = static_cast<int>(begin); i < end; i++) {
+          double* c_row = c + static_cast<long>(i) * m;
+          const double* a_row = band_.data() + static_cast<long>(i) * width;
+          int first = std::max(0, i - lower_);
+          int last = std::min(n - 1, i + upper_);
+          for (auto k = first; k <= last; k++) {
+            double a = a_row[k - i + lower_];
+            const double* b_row = b_data + static_cast<long>(k) * m;
+            for (auto j = 0; j < m; j++) c_row[j] += a * b_row[j];
+          }
+        }
+      });
+  return result;
+}
+
+double S21BandMatrix::Determinant() const {
+  return S21BandLU(*this).Determinant();
+}
+
+S21Matrix S21BandMatrix::Solve(const S21Matrix& rhs) const {
+  return S21BandLU(*this).Solve(rhs);
+}
+
+// band LU
+
+S21BandLU::S21BandLU(const S21BandMatrix& matrix)
+    : size_(matrix.size_),
+      lower_(matrix.lower_),
+      width_(2 * matrix.lower_ + matrix.upper_ + 1),
+      factors_(static_cast<std::size_t>(matrix.size_) * width_),
+      pivots_(matrix.size_),
+      singular_(false) {
+  const int n = size_;
+  const int reach = matrix.upper_ + lower_;
+  for (auto i = 0; i < n; i++) {
+    int first = std::max(0, i - lower_);
+    int last = std::min(n - 1, i + matrix.upper_);
+    for (auto j = first; j <= last; j++) at(i, j) = matrix(i, j);
+  }
+  for (auto k = 0; k < n; k++) {
+    int bottom = std::min(n - 1, k + lower_);
+    int right = std::min(n - 1, k + reach);
+    int pivot = k;
+    for (auto i = k + 1; i <= bottom; i++) {
+      if (std::fabs(at(i, k)) > std::fabs(at(pivot, k))) pivot = i;
+    }
+    pivots_[k] = pivot;
+    if (at(pivot, k) == 0.0) {
+      singular_ = true;
+      continue;
+    }
+    if (pivot != k) {
+      for (auto j = k; j <= right; j++) std::swap(at(k, j), at(pivot, j));
+    }
+    for (auto i = k + 1; i <= bottom; i++) {
+      double factor = at(i, k) /= at(k, k);
+      for (auto j = k + 1; j <= right; j++) at(i, j) -= factor * at(k, j);
+    }
+  }
+}
+
+double& S21BandLU::at(int row, int col) noexcept {
+  return factors_[static_cast<std::size_t>(row) * width_ +
+                  (col - row + lower_)];
+}
+
+double S21BandLU::at(int row, int col) const noexcept {
+  return factors_[static_cast<std::size_t>(row) * width_ +
+                  (col - row + lower_)];
+}
+
+bool S21BandLU::IsSingular() const noexcept { return singular_; }
+
+double S21BandLU::Determinant() const noexcept {
+  if (singular_) return 0.0;
+  double result = 1.0;
+  for (auto k = 0; k < size_; k++) {
+    result *= pivots_[k] == k ? at(k, k) : -at(k, k);
+  }
+  return result;
+}
+
+S21Matrix S21BandLU::Solve(const S21Matrix& rhs) const {
+  checkProduct(size_, rhs);
+  if (singular_) throw std::logic_error("The matrix is singular.");
+  const int n = size_;
+  const int m = rhs.GetCols();
+  const int reach = width_ - lower_ - 1;
+  S21Matrix result = rhs.ToLayout(S21Layout::kRowMajor);
+  double* x = result.data();
+  // the interchanges are applied in the order elimination made them, L is
+  // stored without the later ones
+  for (auto k = 0; k < n; k++) {
+    double* x_k = x + static_cast<long>(k) * m;
+    if (pivots_[k] != k) {
+      std::swap_ranges(x_k, x_k + m, x + static_cast<long>(pivots_[k]) * m);
+    }
+    for (auto i = k + 1; i <= std::min(n - 1, k + lower_); i++) {
+      double factor = at(i, k);
+      double* x_i = x + static_cast<long>(i) * m;
+      for (auto j = 0; j < m; j++) x_i[j] -= factor * x_k[j];
+    }
+  }
+  for (auto i = n - 1; i >= 0; i--) {
+    double* x_i = x + static_cast<long>(i) * m;
+    for (auto k = i + 1; k <= std::min(n - 1, i + reach); k++) {
+      double factor = at(i, k);
+      const double* x_k = x + static_cast<long>(k) * m;
+      for (auto j = 0; j < m; j++) x_i[j] -= factor * x_k[j];
+    }
+    for (auto j = 0; j < m; j++) x_i[j] /= at(i, i);
+  }
+  return result;
+}
@@ -0,0 +1,116 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_STRUCTURED_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_STRUCTURED_H_
+
+#include <vector>
+
+#include "s21_matrix/s21_matrix_oop.h"
+
+// square matrices that store only the elements their structure allows;
+// reads outside the structure give 0, writes there throw std::out_of_range
+
+// symmetric matrix, the lower triangle packed by rows, n(n+1)/2 elements
+class S21SymmetricMatrix {
+ public:
+  explicit S21SymmetricMatrix(int size);
+  // takes the lower triangle of a square matrix
+  static S21SymmetricMatrix FromDense(const S21Matrix& matrix);
+  // SYRK: alpha * A * A^T for any n x k matrix A, computing one triangle
+  static S21SymmetricMatrix Syrk(const S21Matrix& a, double alpha = 1.0);
+
+  int GetSize() const noexcept;
+  // (row, col) and (col, row) are the same element
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+  S21Matrix ToDense() const;
+
+  // SYMM: this * other
+  S21Matrix Multiply(const S21Matrix& other) const;
+
+ private:
+  int size_;
+  std::vector<double> packed_;
+  std::size_t index(int row, int col) const;
+};
+
+enum class S21Triangle { kLower, kUpper };
+
+// lower or upper triangular matrix packed by rows, n(n+1)/2 elements
+class S21TriangularMatrix {
+ public:
+  S21TriangularMatrix(int size, S21Triangle triangle);
+  // takes the given triangle of a square matrix
+  static S21TriangularMatrix FromDense(const S21Matrix& matrix,
+                                       S21Triangle triangle);
+
+  int GetSize() const noexcept;
+  S21Triangle GetTriangle() const noexcept;
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+  S21Matrix ToDense() const;
+
+  // product of the diagonal
+  double Determinant() const noexcept;
+  // TRMM: this * other
+  S21Matrix Multiply(const S21Matrix& other) const;
+  // TRSM: X with this * X = rhs, throws std::logic_error on a zero diagonal
+  S21Matrix Solve(const S21Matrix& rhs) const;
+
+ private:
+  int size_;
+  S21Triangle triangle_;
+  std::vector<double> packed_;
+  bool contains(int row, int col) const noexcept;
+  std::size_t index(int row, int col) const noexcept;
+};
+
+// band matrix with lower sub- and upper super-diagonals, stored by rows in
+// n * (lower + upper + 1) elements
+class S21BandMatrix {
+ public:
+  S21BandMatrix(int size, int lower, int upper);
+  // takes the band of a square matrix
+  static S21BandMatrix FromDense(const S21Matrix& matrix, int lower,
+                                 int upper);
+
+  int GetSize() const noexcept;
+  int GetLower() const noexcept;
+  int GetUpper() const noexcept;
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+  S21Matrix ToDense() const;
+
+  // this * other in O(n (lower + upper) m)
+  S21Matrix Multiply(const S21Matrix& other) const;
+  // through the banded LU factorization
+  double Determinant() const;
+  S21Matrix Solve(const S21Matrix& rhs) const;
+
+ private:
+  friend class S21BandLU;
+  int size_, lower_, upper_;
+  std::vector<double> band_;
+  bool contains(int row, int col) const noexcept;
+};
+
+// banded LU with partial pivoting in O(n lower (lower + upper)); row
+// interchanges widen U to lower + upper super-diagonals
+class S21BandLU {
+ public:
+  explicit S21BandLU(const S21BandMatrix& matrix);
+
+  bool IsSingular() const noexcept;
+  double Determinant() const noexcept;
+  // X with A * X = rhs, throws std::logic_error if A is singular
+  S21Matrix Solve(const S21Matrix& rhs) const;
+
+ private:
+  int size_, lower_, width_;
+  // row i holds columns i - lower_ .. i - lower_ + width_ - 1
+  std::vector<double> factors_;
+  std::vector<int> pivots_;
+  bool singular_;
+  double& at(int row, int col) noexcept;
+  double at(int row, int col) const noexcept;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_STRUCTURED_H_
@@ -0,0 +1,42 @@
+#include "s21_matrix/s21_task.h"
+
+#include <utility>
+
+S21CancellationToken::S21CancellationToken()
+    : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+void S21CancellationToken::Cancel() noexcept {
+  cancelled_->store(true, std::memory_order_relaxed);
+}
+
+bool S21CancellationToken::IsCancelled() const noexcept {
+  return cancelled_->load(std::memory_order_relaxed);
+}
+
+S21Cancelled::S21Cancelled()
+    : std::runtime_error("The operation was cancelled.") {}
+
+S21TaskControl::S21TaskControl(const S21CancellationToken& token,
+                               std::function<void(double)> progress)
+    : cancelled_(token.cancelled_), progress_(std::move(progress)) {}
+
+S21TaskControl::S21TaskControl(std::function<void(double)> progress)
+    : progress_(std::move(progress)) {}
+
+void S21TaskControl::Checkpoint(double fraction) const {
+  if (progress_) progress_(fraction);
+  if (cancelled_ && cancelled_->load(std::memory_order_relaxed)) {
+    throw S21Cancelled();
+  }
+}
+
+S21TaskControl S21TaskControl::Stage(double begin, double end) const {
+  S21TaskControl stage;
+  stage.cancelled_ = cancelled_;
+  if (progress_) {
+    stage.progress_ = [progress = progress_, begin, end](double fraction) {
+      progress(begin + (end - begin) * fraction);
+    };
+  }
+  return stage;
+}
@@ -0,0 +1,49 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TASK_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TASK_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+// flag that asks running operations to stop, copies share it
+class S21CancellationToken {
+ public:
+  S21CancellationToken();
+
+  void Cancel() noexcept;
+  bool IsCancelled() const noexcept;
+
+ private:
+  friend class S21TaskControl;
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+// thrown out of a cancelled operation, and so out of its future
+class S21Cancelled : public std::runtime_error {
+ public:
+  S21Cancelled();
+};
+
+// cancellation and progress reporting for a long operation; the default
+// one never cancels and reports nothing
+class S21TaskControl {
+ public:
+  S21TaskControl() = default;
+  // progress receives the fraction of the work done, in [0, 1], on the
+  // thread running the operation
+  explicit S21TaskControl(const S21CancellationToken& token,
+                          std::function<void(double)> progress = nullptr);
+  explicit S21TaskControl(std::function<void(double)> progress);
+
+  // reports fraction, then throws S21Cancelled if the token was cancelled
+  void Checkpoint(double fraction) const;
+  // control for a stage that covers [begin, end] of the whole operation
+  S21TaskControl Stage(double begin, double end) const;
+
+ private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+  std::function<void(double)> progress_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TASK_H_
@@ -0,0 +1,162 @@
+#include "s21_matrix/s21_thread_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+#include "s21_matrix/s21_numa.h"
+
+#ifdef __unix__
+#include <pthread.h>
+#endif
+
+namespace {
+// index of the pool worker running on this thread, -1 outside the pool
+thread_local int current_worker = -1;
+
+// a forked child has no workers, only the thread that called fork
+std::atomic<bool> forked_child{false};
+#ifdef __unix__
+[[maybe_unused]] const int fork_handler =
+    pthread_atfork(nullptr, nullptr, [] { forked_child = true; });
+#endif
+}  // namespace
+
+S21ThreadPool& S21ThreadPool::Instance() {
+  static S21ThreadPool pool([] {
+    const char* threads = std::getenv("S21_THREADS");
+    int count = threads ? std::atoi(threads) : 0;
+    return count > 0 ? count
+                     : static_cast<int>(std::thread::hardware_concurrency());
+  }());
+  return pool;
+}
+
+S21ThreadPool::S21ThreadPool(int threads)
+    : workers_(threads > 0 ? threads : 1), stopping_(false), pinned_(false) {
+  for (auto i = 0; i < ThreadCount(); i++) {
+    workers_[i].threads.emplace_back(&S21ThreadPool::run, this, i);
+  }
+  for (auto i = 0; i < kCoordinators; i++) {
+    coordinator_.threads.emplace_back([this] { serve(coordinator_); });
+  }
+}
+
+S21ThreadPool::~S21ThreadPool() {
+  stopping_ = true;
+  // submitted tasks still need the workers to finish
+  stop(coordinator_);
+  for (auto& worker : workers_) stop(worker);
+}
+
+void S21ThreadPool::stop(Worker& worker) {
+  // a worker between its predicate check and its wait holds the mutex
+  { std::lock_guard<std::mutex> lock(worker.mutex); }
+  worker.ready.notify_all();
+  for (auto& thread : worker.threads) thread.join();
+}
+
+int S21ThreadPool::ThreadCount() const noexcept {
+  return static_cast<int>(workers_.size());
+}
+
+long S21ThreadPool::BlockBegin(long count, int parts, int index) noexcept {
+  return count * index / parts;
+}
+
+void S21ThreadPool::SetPinned(bool pinned) noexcept {
+  pinned_.store(pinned, std::memory_order_relaxed);
+}
+
+void S21ThreadPool::run(int index) {
+  current_worker = index;
+  serve(workers_[index]);
+}
+
+void S21ThreadPool::place(int index, bool& pinned) {
+  const bool wanted = pinned_.load(std::memory_order_relaxed);
+  if (wanted == pinned) return;
+  pinned = wanted;
+  int nodes = S21Numa::NodeCount();
+  if (nodes <= 1) return;
+  if (wanted) {
+    S21Numa::BindCurrentThread(index * nodes / ThreadCount());
+  } else {
+    S21Numa::UnbindCurrentThread();
+  }
+}
+
+void S21ThreadPool::serve(Worker& worker) {
+  // whether this thread is bound to its node, workers only
+  bool pinned = false;
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      worker.ready.wait(lock,
+                        [&] { return stopping_ || !worker.tasks.empty(); });
+      if (worker.tasks.empty()) return;
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+    }
+    if (current_worker >= 0) place(current_worker, pinned);
+    task();
+  }
+}
+
+void S21ThreadPool::push(Worker& worker, std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+  }
+  worker.ready.notify_one();
+}
+
+void S21ThreadPool::Submit(std::function<void()> task) {
+  if (forked_child) {
+    task();
+    return;
+  }
+  push(coordinator_, std::move(task));
+}
+
+void S21ThreadPool::ParallelRows(
+    long rows, long work_per_row,
+    const std::function<void(long, long)>& body) {
+  Instance().ParallelFor(
+      rows, std::max(1L, kParallelMinWork / std::max(1L, work_per_row)),
+      body);
+}
+
+void S21ThreadPool::ParallelFor(long count, long min_block,
+                                const std::function<void(long, long)>& body) {
+  int parts = ThreadCount();
+  if (count <= 0) return;
+  if (parts == 1 || count < 2 * min_block || current_worker >= 0 ||
+      forked_child) {
+    body(0, count);
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable done;
+  int remaining = parts;
+  std::exception_ptr error;
+  for (auto w = 0; w < parts; w++) {
+    push(workers_[w], [&, w] {
+      try {
+        long begin = BlockBegin(count, parts, w);
+        long end = BlockBegin(count, parts, w + 1);
+        if (begin < end) body(begin, end);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--remaining == 0) done.notify_one();
+    });
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&] { return remaining == 0; });
+  if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,80 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_THREAD_POOL_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class S21ThreadPool {
+ public:
+  // pool shared by the matrix kernels, one worker per hardware thread or
+  // as many as the S21_THREADS environment variable asks for
+  static S21ThreadPool& Instance();
+
+  explicit S21ThreadPool(int threads);
+  S21ThreadPool(const S21ThreadPool&) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool&) = delete;
+  ~S21ThreadPool();
+
+  int ThreadCount() const noexcept;
+
+  // splits [0, count) into ThreadCount() contiguous blocks, block w always
+  // runs on worker w so data first touched by a block stays local to the
+  // worker that processes it later; runs inline when count < 2 * min_block
+  // or when called from a worker thread or a forked child process
+  void ParallelFor(long count, long min_block,
+                   const std::function<void(long, long)>& body);
+
+  // amount of work below which kernels stay on the calling thread
+  static constexpr long kParallelMinWork = 1 << 16;
+  // ParallelFor of Instance() over rows in blocks of at least
+  // kParallelMinWork, work_per_row being the cost of one row; the same row
+  // blocks map to the same workers, which first touched them under
+  // kFirstTouch
+  static void ParallelRows(long rows, long work_per_row,
+                           const std::function<void(long, long)>& body);
+
+  // runs task on one of kCoordinators threads outside the workers, so the
+  // kernels it calls still spread over the whole pool; tasks start in
+  // submission order and up to kCoordinators of them run at once, so a
+  // short task need not wait for a long one; a forked child runs task
+  // right away
+  void Submit(std::function<void()> task);
+  static constexpr int kCoordinators = 4;
+
+  // pins every worker to the NUMA node of its blocks, or gives it back the
+  // cpus it started with; workers follow before their next task, and stay
+  // unpinned until this is first called
+  void SetPinned(bool pinned) noexcept;
+
+  // bounds of block index out of parts equal blocks of [0, count)
+  static long BlockBegin(long count, int parts, int index) noexcept;
+
+ private:
+  // a task queue and the threads serving it, one for every worker and
+  // kCoordinators for the coordinator queue
+  struct Worker {
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<std::thread> threads;
+  };
+
+  std::vector<Worker> workers_;
+  Worker coordinator_;
+  std::atomic<bool> stopping_;
+  std::atomic<bool> pinned_;
+  void run(int index);
+  // binds or unbinds the calling worker to follow pinned_
+  void place(int index, bool& pinned);
+  // runs the tasks of worker until the pool stops and the queue is empty
+  void serve(Worker& worker);
+  void push(Worker& worker, std::function<void()> task);
+  void stop(Worker& worker);
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_THREAD_POOL_H_
@@ -0,0 +1,126 @@
+#include "s21_matrix/s21_tile_graph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+#include "s21_matrix/s21_thread_pool.h"
+
+S21TileGraph::S21TileGraph(S21Schedule schedule)
+    : schedule_(schedule), barrier_(-1) {}
+
+int S21TileGraph::TaskCount() const noexcept {
+  return static_cast<int>(tasks_.size());
+}
+
+void S21TileGraph::addEdge(int from, int to) {
+  tasks_[from].successors.push_back(to);
+  tasks_[to].waiting++;
+}
+
+void S21TileGraph::AddTask(std::function<void()> body,
+                           const std::vector<long>& reads,
+                           const std::vector<long>& writes, int priority) {
+  const int id = TaskCount();
+  tasks_.push_back({std::move(body), {}, 0, priority});
+  std::vector<int> depends;
+  if (barrier_ >= 0) depends.push_back(barrier_);
+  for (long tile : reads) {
+    auto found = accesses_.find(tile);
+    if (found != accesses_.end() && found->second.writer >= 0) {
+      depends.push_back(found->second.writer);
+    }
+  }
+  for (long tile : writes) {
+    auto found = accesses_.find(tile);
+    if (found == accesses_.end()) continue;
+    if (found->second.writer >= 0) depends.push_back(found->second.writer);
+    depends.insert(depends.end(), found->second.readers.begin(),
+                   found->second.readers.end());
+  }
+  std::sort(depends.begin(), depends.end());
+  depends.erase(std::unique(depends.begin(), depends.end()), depends.end());
+  for (int from : depends) addEdge(from, id);
+
+  for (long tile : reads) accesses_[tile].readers.push_back(id);
+  for (long tile : writes) {
+    Access& access = accesses_[tile];
+    access.writer = id;
+    access.readers.clear();
+  }
+  if (schedule_ == S21Schedule::kForkJoin) phase_.push_back(id);
+}
+
+void S21TileGraph::Barrier() {
+  if (schedule_ != S21Schedule::kForkJoin || phase_.empty()) return;
+  std::vector<int> phase = std::move(phase_);
+  phase_.clear();
+  barrier_ = -1;
+  // an empty task joining the phase
+  AddTask([] {}, {}, {});
+  int join = TaskCount() - 1;
+  phase_.clear();
+  for (int from : phase) addEdge(from, join);
+  barrier_ = join;
+}
+
+void S21TileGraph::Run() {
+  std::vector<Task> tasks = std::move(tasks_);
+  tasks_.clear();
+  accesses_.clear();
+  phase_.clear();
+  barrier_ = -1;
+  if (tasks.empty()) return;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  // highest priority first, then the earliest added
+  std::priority_queue<std::pair<int, int>> ready;
+  for (auto id = 0; id < static_cast<int>(tasks.size()); id++) {
+    if (tasks[id].waiting == 0) ready.emplace(tasks[id].priority, -id);
+  }
+  std::size_t finished = 0;
+  std::exception_ptr error;
+
+  // every worker runs this loop and takes whichever task is ready next
+  auto work = [&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      changed.wait(lock, [&] {
+        return !ready.empty() || finished == tasks.size() || error;
+      });
+      if (finished == tasks.size() || error) return;
+      int id = -ready.top().second;
+      ready.pop();
+      lock.unlock();
+      try {
+        tasks[id].body();
+      } catch (...) {
+        lock.lock();
+        if (!error) error = std::current_exception();
+        changed.notify_all();
+        return;
+      }
+      lock.lock();
+      int woken = 0;
+      for (int next : tasks[id].successors) {
+        if (--tasks[next].waiting == 0) {
+          ready.emplace(tasks[next].priority, -next);
+          woken++;
+        }
+      }
+      finished++;
+      if (finished == tasks.size() || woken > 1) {
+        changed.notify_all();
+      } else if (woken == 1) {
+        changed.notify_one();
+      }
+    }
+  };
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  pool.ParallelFor(pool.ThreadCount(), 1, [&](long, long) { work(); });
+  if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,55 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TILE_GRAPH_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TILE_GRAPH_H_
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// how a tiled algorithm runs its tasks: kDataflow starts every task as soon
+// as the tiles it reads are written, kForkJoin finishes each phase before
+// the next one like a sequence of parallel loops
+enum class S21Schedule { kDataflow, kForkJoin };
+
+// task graph over tiles: dependencies come from the tiles each task reads
+// and writes, in the order the tasks were added (read after write, write
+// after read and write after write); Run executes the ready tasks on the
+// thread pool workers, higher priority first
+class S21TileGraph {
+ public:
+  explicit S21TileGraph(S21Schedule schedule = S21Schedule::kDataflow);
+
+  // tiles are any keys the caller chooses, usually row * tiles + col
+  void AddTask(std::function<void()> body, const std::vector<long>& reads,
+               const std::vector<long>& writes, int priority = 0);
+  // end of a phase, the tasks added later wait for all earlier ones under
+  // kForkJoin and only for their data under kDataflow
+  void Barrier();
+  int TaskCount() const noexcept;
+
+  // runs every task and empties the graph; the first exception thrown by a
+  // task stops the run and is rethrown here
+  void Run();
+
+ private:
+  struct Task {
+    std::function<void()> body;
+    std::vector<int> successors;
+    int waiting;
+    int priority;
+  };
+  // last writer of a tile and the readers since
+  struct Access {
+    int writer = -1;
+    std::vector<int> readers;
+  };
+
+  S21Schedule schedule_;
+  std::vector<Task> tasks_;
+  std::unordered_map<long, Access> accesses_;
+  // task every later task waits for and the tasks since it, kForkJoin only
+  int barrier_;
+  std::vector<int> phase_;
+  void addEdge(int from, int to);
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TILE_GRAPH_H_
@@ -0,0 +1,352 @@
+#include "s21_matrix/s21_transport.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "s21_matrix/s21_thread_pool.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace {
+void checkSize(int size) {
+  if (size < 1) throw std::invalid_argument("Incorrect input, no ranks");
+}
+
+void checkRank(int rank, int size) {
+  if (rank < 0 || rank >= size) {
+    throw std::out_of_range("Incorrect input, rank is out of range");
+  }
+}
+}  // namespace
+
+// local
+
+struct S21LocalTransport::Hub {
+  struct Message {
+    int tag;
+    std::vector<double> data;
+  };
+  // mailbox of a receiving rank, a queue per sending rank
+  struct Mailbox {
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::vector<std::deque<Message>> from;
+  };
+
+  explicit Hub(int size) : mailboxes(size) {
+    for (auto& mailbox : mailboxes) mailbox.from.resize(size);
+  }
+  std::vector<Mailbox> mailboxes;
+};
+
+S21LocalTransport::S21LocalTransport(std::shared_ptr<Hub> hub, int rank)
+    : hub_(std::move(hub)), rank_(rank) {}
+
+void S21LocalTransport::Run(int size,
+                            const std::function<void(S21Transport&)>& body) {
+  checkSize(size);
+  auto hub = std::make_shared<Hub>(size);
+  std::vector<std::exception_ptr> errors(size);
+  std::vector<std::thread> threads;
+  for (auto rank = 0; rank < size; rank++) {
+    threads.emplace_back([&, rank] {
+      S21LocalTransport transport(hub, rank);
+      try {
+        body(transport);
+      } catch (...) {
+        errors[rank] = std::current_exception();
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (auto& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+int S21LocalTransport::Rank() const noexcept { return rank_; }
+
+int S21LocalTransport::Size() const noexcept {
+  return static_cast<int>(hub_->mailboxes.size());
+}
+
+void S21LocalTransport::Send(int to, int tag, const double* data,
+                             std::size_t count) {
+  checkRank(to, Size());
+  Hub::Mailbox& mailbox = hub_->mailboxes[to];
+  {
+    std::lock_guard<std::mutex> lock(mailbox.mutex);
+    mailbox.from[rank_].push_back(
+        {tag, std::vector<double>(data, data + count)});
+  }
+  mailbox.arrived.notify_all();
+}
+
+std::vector<double> S21LocalTransport::Receive(int from, int tag) {
+  checkRank(from, Size());
+  Hub::Mailbox& mailbox = hub_->mailboxes[rank_];
+  std::deque<Hub::Message>& queue = mailbox.from[from];
+  std::unique_lock<std::mutex> lock(mailbox.mutex);
+  for (;;) {
+    auto found = std::find_if(queue.begin(), queue.end(),
+                              [tag](const Hub::Message& message) {
+                                return message.tag == tag;
+                              });
+    if (found != queue.end()) {
+      std::vector<double> data = std::move(found->data);
+      queue.erase(found);
+      return data;
+    }
+    mailbox.arrived.wait(lock);
+  }
+}
+
+// sockets
+
+#ifdef __linux__
+
+namespace {
+// a frame is the tag and the count as 64-bit integers, then the doubles
+constexpr std::size_t kHeader = 2 * sizeof(std::int64_t);
+}  // namespace
+
+S21SocketTransport::S21SocketTransport(int rank,
+                                       const std::vector<int>& sockets)
+    : rank_(rank), peers_(sockets.size()) {
+  for (std::size_t i = 0; i < sockets.size(); i++) {
+    peers_[i].socket = sockets[i];
+  }
+}
+
+S21SocketTransport::~S21SocketTransport() {
+  for (auto& peer : peers_) {
+    if (peer.socket >= 0) close(peer.socket);
+  }
+}
+
+void S21SocketTransport::Spawn(
+    int size, const std::function<void(S21Transport&)>& body) {
+  checkSize(size);
+  // children must not inherit a pool that is still being constructed
+  S21ThreadPool::Instance();
+  std::vector<std::vector<int>> sockets(size, std::vector<int>(size, -1));
+  for (auto i = 0; i < size; i++) {
+    for (auto j = i + 1; j < size; j++) {
+      int pair[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+        for (auto& row : sockets) {
+          for (int socket : row) {
+            if (socket >= 0) close(socket);
+          }
+        }
+        throw std::runtime_error("Cannot create a socket pair");
+      }
+      sockets[i][j] = pair[0];
+      sockets[j][i] = pair[1];
+    }
+  }
+  // closes the ends that belong to other ranks
+  auto keep = [&](int rank) {
+    for (auto i = 0; i < size; i++) {
+      for (auto j = 0; j < size; j++) {
+        if (i != rank && sockets[i][j] >= 0) close(sockets[i][j]);
+      }
+    }
+  };
+
+  std::vector<pid_t> children;
+  for (auto rank = 1; rank < size; rank++) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      keep(rank);
+      int status = 0;
+      {
+        S21SocketTransport transport(rank, sockets[rank]);
+        try {
+          body(transport);
+        } catch (...) {
+          status = 1;
+        }
+      }
+      _exit(status);
+    }
+    if (pid < 0) break;
+    children.push_back(pid);
+  }
+  keep(0);
+  std::exception_ptr error;
+  if (static_cast<int>(children.size()) != size - 1) {
+    error = std::make_exception_ptr(std::runtime_error("Cannot fork a rank"));
+    for (int socket : sockets[0]) {
+      if (socket >= 0) close(socket);
+    }
+  } else {
+    // the children see end of file on their sockets if rank 0 fails
+    S21SocketTransport transport(0, sockets[0]);
+    try {
+      body(transport);
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  bool failed = false;
+  for (pid_t child : children) {
+    int status = 0;
+    while (waitpid(child, &status, 0) < 0 && errno == EINTR) {
+    }
+    failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+  }
+  if (error) std::rethrow_exception(error);
+  if (failed) throw std::runtime_error("A rank of the computation failed");
+}
+
+int S21SocketTransport::Rank() const noexcept { return rank_; }
+
+int S21SocketTransport::Size() const noexcept {
+  return static_cast<int>(peers_.size());
+}
+
+void S21SocketTransport::readFrom(int index) {
+  Peer& peer = peers_[index];
+  char buffer[1 << 16];
+  for (;;) {
+    ssize_t got = recv(peer.socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (got == 0) {
+      // the rank is done, what it sent before stays queued
+      close(peer.socket);
+      peer.socket = -1;
+      break;
+    }
+    if (got < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      throw std::runtime_error("Cannot receive from a rank");
+    }
+    peer.partial.insert(peer.partial.end(), buffer, buffer + got);
+  }
+  std::size_t used = 0;
+  while (peer.partial.size() - used >= kHeader) {
+    std::int64_t header[2];
+    std::memcpy(header, peer.partial.data() + used, kHeader);
+    std::size_t bytes = static_cast<std::size_t>(header[1]) * sizeof(double);
+    if (peer.partial.size() - used < kHeader + bytes) break;
+    Message message{static_cast<int>(header[0]),
+                    std::vector<double>(static_cast<std::size_t>(header[1]))};
+    if (bytes) {
+      std::memcpy(message.data.data(), peer.partial.data() + used + kHeader,
+                  bytes);
+    }
+    peer.messages.push_back(std::move(message));
+    used += kHeader + bytes;
+  }
+  peer.partial.erase(peer.partial.begin(), peer.partial.begin() + used);
+}
+
+bool S21SocketTransport::progress(int writable) {
+  std::vector<pollfd> fds;
+  std::vector<int> owners;
+  for (auto i = 0; i < Size(); i++) {
+    if (peers_[i].socket < 0) continue;
+    short events = POLLIN;
+    if (i == writable) events |= POLLOUT;
+    fds.push_back({peers_[i].socket, events, 0});
+    owners.push_back(i);
+  }
+  while (poll(fds.data(), fds.size(), -1) < 0) {
+    if (errno != EINTR) throw std::runtime_error("Cannot wait for a rank");
+  }
+  bool ready = false;
+  for (std::size_t k = 0; k < fds.size(); k++) {
+    if (fds[k].revents & (POLLIN | POLLHUP | POLLERR)) readFrom(owners[k]);
+    if (owners[k] == writable && (fds[k].revents & POLLOUT)) ready = true;
+  }
+  return ready;
+}
+
+void S21SocketTransport::Send(int to, int tag, const double* data,
+                              std::size_t count) {
+  checkRank(to, Size());
+  if (to == rank_) {
+    peers_[to].messages.push_back(
+        {tag, std::vector<double>(data, data + count)});
+    return;
+  }
+  std::vector<char> frame(kHeader + count * sizeof(double));
+  std::int64_t header[2] = {tag, static_cast<std::int64_t>(count)};
+  std::memcpy(frame.data(), header, kHeader);
+  if (count) std::memcpy(frame.data() + kHeader, data, count * sizeof(double));
+  std::size_t sent = 0;
+  while (sent < frame.size()) {
+    if (peers_[to].socket < 0) {
+      throw std::runtime_error("A rank closed its connection");
+    }
+    if (!progress(to)) continue;
+    ssize_t put = send(peers_[to].socket, frame.data() + sent,
+                       frame.size() - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (put > 0) {
+      sent += put;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      throw std::runtime_error("Cannot send to a rank");
+    }
+  }
+}
+
+std::vector<double> S21SocketTransport::Receive(int from, int tag) {
+  checkRank(from, Size());
+  std::deque<Message>& queue = peers_[from].messages;
+  for (;;) {
+    auto found = std::find_if(
+        queue.begin(), queue.end(),
+        [tag](const Message& message) { return message.tag == tag; });
+    if (found != queue.end()) {
+      std::vector<double> data = std::move(found->data);
+      queue.erase(found);
+      return data;
+    }
+    if (from == rank_) {
+      throw std::logic_error("Incorrect input, no message sent to itself");
+    }
+    if (peers_[from].socket < 0) {
+      throw std::runtime_error("A rank closed its connection");
+    }
+    progress(-1);
+  }
+}
+
+#else
+
+S21SocketTransport::S21SocketTransport(int rank, const std::vector<int>&)
+    : rank_(rank) {}
+
+S21SocketTransport::~S21SocketTransport() {}
+
+void S21SocketTransport::Spawn(int, const std::function<void(S21Transport&)>&) {
+  throw std::runtime_error("Socket transport needs Linux");
+}
+
+int S21SocketTransport::Rank() const noexcept { return rank_; }
+
+int S21SocketTransport::Size() const noexcept { return 0; }
+
+void S21SocketTransport::Send(int, int, const double*, std::size_t) {}
+
+std::vector<double> S21SocketTransport::Receive(int, int) { return {}; }
+
+bool S21SocketTransport::progress(int) { return false; }
+
+void S21SocketTransport::readFrom(int) {}
+
+#endif
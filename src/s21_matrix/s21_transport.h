@@ -0,0 +1,86 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TRANSPORT_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TRANSPORT_H_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// point-to-point messages of doubles between the ranks 0 .. Size() - 1 of a
+// distributed computation; messages from one rank to another with the same
+// tag arrive in the order they were sent, Send never waits for the matching
+// Receive, so two ranks may send to each other before either receives
+class S21Transport {
+ public:
+  virtual ~S21Transport() = default;
+
+  virtual int Rank() const noexcept = 0;
+  virtual int Size() const noexcept = 0;
+  virtual void Send(int to, int tag, const double* data,
+                    std::size_t count) = 0;
+  // waits for the next message from rank from with tag
+  virtual std::vector<double> Receive(int from, int tag) = 0;
+};
+
+// ranks as threads of this process, messages go through shared queues
+class S21LocalTransport : public S21Transport {
+ public:
+  // runs body on size threads, one per rank, and rethrows the first
+  // exception any of them threw once all have finished
+  static void Run(int size, const std::function<void(S21Transport&)>& body);
+
+  int Rank() const noexcept override;
+  int Size() const noexcept override;
+  void Send(int to, int tag, const double* data, std::size_t count) override;
+  std::vector<double> Receive(int from, int tag) override;
+
+ private:
+  struct Hub;
+  S21LocalTransport(std::shared_ptr<Hub> hub, int rank);
+  std::shared_ptr<Hub> hub_;
+  int rank_;
+};
+
+// ranks as processes of this machine connected pairwise by Unix domain
+// sockets; while a send waits for buffer space it keeps reading whatever the
+// other ranks send, so crossing sends cannot deadlock
+class S21SocketTransport : public S21Transport {
+ public:
+  // forks size - 1 children as ranks 1 and up, the caller is rank 0; each
+  // child runs body and exits. Throws std::runtime_error if a child failed
+  // and rethrows an exception of rank 0. The thread pool of a child runs
+  // its kernels on the calling thread, one process is one core's worth
+  static void Spawn(int size, const std::function<void(S21Transport&)>& body);
+
+  S21SocketTransport(const S21SocketTransport&) = delete;
+  S21SocketTransport& operator=(const S21SocketTransport&) = delete;
+  ~S21SocketTransport() override;
+
+  int Rank() const noexcept override;
+  int Size() const noexcept override;
+  void Send(int to, int tag, const double* data, std::size_t count) override;
+  std::vector<double> Receive(int from, int tag) override;
+
+ private:
+  struct Message {
+    int tag;
+    std::vector<double> data;
+  };
+  struct Peer {
+    int socket = -1;
+    // bytes of a frame not complete yet
+    std::vector<char> partial;
+    std::deque<Message> messages;
+  };
+
+  S21SocketTransport(int rank, const std::vector<int>& sockets);
+  int rank_;
+  std::vector<Peer> peers_;
+  // waits until some socket is readable, or also until writable is, and
+  // reads everything available; returns whether writable can take data
+  bool progress(int writable);
+  void readFrom(int peer);
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_S21_TRANSPORT_H_
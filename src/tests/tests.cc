@@ -1,6 +1,48 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <future>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "s21_matrix/s21_cholesky.h"
+#include "s21_matrix/s21_distributed.h"
+#include "s21_matrix/s21_factor_cache.h"
+#include "s21_matrix/s21_lowrank.h"
+#include "s21_matrix/s21_lu.h"
+#include "s21_matrix/s21_matrix_c.h"
 #include "s21_matrix/s21_matrix_oop.h"
+#include "s21_matrix/s21_structured.h"
+#include "s21_matrix/s21_thread_pool.h"
+
+// counts element buffer allocations so tests can check that they are reused
+static std::atomic<long> allocations{0};
+
+__attribute__((noinline)) void* operator new[](std::size_t size) {
+  allocations++;
+  if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+__attribute__((noinline)) void operator delete[](void* ptr,
+                                                std::size_t) noexcept {
+  std::free(ptr);
+}
 
 TEST(constructors, negative) { EXPECT_ANY_THROW(S21Matrix m(-1, -2)); }
 
@@ -576,6 +618,1448 @@ TEST(errors, index_operator) {
   EXPECT_THROW(A(-1, 0), std::logic_error);
 }
 
+TEST(shared, copies_share_storage) {
+  S21Matrix m1(3, 3);
+  m1(1, 1) = 5.0;
+  m1.SetShared(true);
+
+  S21Matrix m2(m1);
+  S21Matrix m3;
+  m3 = m2;
+  EXPECT_TRUE(m2.IsShared());
+  EXPECT_EQ(m1.UseCount(), 3);
+  EXPECT_EQ(&std::as_const(m1)(1, 1), &std::as_const(m3)(1, 1));
+  EXPECT_TRUE(m1 == m3);
+}
+
+TEST(shared, mutation_detaches) {
+  S21Matrix m1(2, 2);
+  m1(0, 0) = 1.0;
+  m1.SetShared(true);
+  S21Matrix m2(m1);
+  S21Matrix m3(m1);
+
+  m2(0, 0) = 2.0;
+  EXPECT_EQ(m1.UseCount(), 2);
+  EXPECT_EQ(m2.UseCount(), 1);
+  EXPECT_DOUBLE_EQ(m1(0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(m2(0, 0), 2.0);
+
+  m3.SumMatrix(m1);
+  m3.MulNumber(2.0);
+  EXPECT_DOUBLE_EQ(std::as_const(m1)(0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(m3(0, 0), 4.0);
+  EXPECT_EQ(m1.UseCount(), 1);
+}
+
+TEST(shared, not_shared_by_default) {
+  S21Matrix m1(2, 2);
+  S21Matrix m2(m1);
+  EXPECT_FALSE(m1.IsShared());
+  EXPECT_EQ(m1.UseCount(), 1);
+  EXPECT_EQ(m2.UseCount(), 1);
+  EXPECT_EQ(S21Matrix().UseCount(), 0);
+}
+
+TEST(shared, concurrent_copies) {
+  S21Matrix m(4, 4);
+  m(3, 3) = 7.0;
+  m.SetShared(true);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&m]() {
+      for (int i = 0; i < 1000; i++) {
+        S21Matrix copy(m);
+        if (i % 2) copy(0, 0) = i;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(m.UseCount(), 1);
+  EXPECT_DOUBLE_EQ(m(3, 3), 7.0);
+  EXPECT_DOUBLE_EQ(m(0, 0), 0.0);
+}
+
+TEST(rvalue, operators_reuse_temporaries) {
+  S21Matrix a(3, 3), b(3, 3), c(3, 3);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) {
+      a(i, j) = i + j;
+      b(i, j) = i - j;
+      c(i, j) = i * j;
+    }
+
+  long before = allocations;
+  S21Matrix ab = a + b;
+  S21Matrix abc = ab + c;
+  S21Matrix scaled = a * 2.0;
+  S21Matrix lvalue_result = scaled + b;
+  long lvalue_allocations = allocations - before;
+
+  before = allocations;
+  S21Matrix chained = (a + b) + c;
+  S21Matrix rvalue_result = a * 2.0 + b;
+  long rvalue_allocations = allocations - before;
+
+  EXPECT_EQ(lvalue_allocations, 2 * rvalue_allocations);
+  EXPECT_TRUE(chained == abc);
+  EXPECT_TRUE(rvalue_result == lvalue_result);
+
+  before = allocations;
+  S21Matrix diff = (a - b) - c;
+  S21Matrix left = 0.5 * (a + b);
+  S21Matrix transposed = (a - b).Transpose();
+  EXPECT_EQ(allocations - before, rvalue_allocations * 3 / 2);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) {
+      EXPECT_DOUBLE_EQ(diff(i, j), a(i, j) - b(i, j) - c(i, j));
+      EXPECT_DOUBLE_EQ(left(i, j), 0.5 * (a(i, j) + b(i, j)));
+      EXPECT_DOUBLE_EQ(transposed(i, j), a(j, i) - b(j, i));
+    }
+}
+
+TEST(rvalue, transpose_not_square) {
+  S21Matrix m(2, 3);
+  m(0, 2) = 4.0;
+  S21Matrix t = S21Matrix(m).Transpose();
+  EXPECT_EQ(t.GetRows(), 3);
+  EXPECT_EQ(t.GetCols(), 2);
+  EXPECT_DOUBLE_EQ(t(2, 0), 4.0);
+}
+
+TEST(thread_pool, parallel_for_covers_range) {
+  S21ThreadPool pool(4);
+  std::vector<int> visits(1001);
+  pool.ParallelFor(1001, 1, [&](long begin, long end) {
+    for (auto i = begin; i < end; i++) visits[i]++;
+  });
+  for (int count : visits) EXPECT_EQ(count, 1);
+  EXPECT_EQ(S21ThreadPool::BlockBegin(1001, 4, 4), 1001);
+  EXPECT_THROW(pool.ParallelFor(10, 1,
+                                [](long, long) {
+                                  throw std::runtime_error("block failed");
+                                }),
+               std::runtime_error);
+}
+
+TEST(thread_pool, submitted_tasks_use_the_workers) {
+  S21ThreadPool pool(3);
+  std::vector<int> visits(300);
+  std::promise<void> done;
+  pool.Submit([&] {
+    // not a worker itself, so the loop is split between the workers
+    pool.ParallelFor(300, 1, [&](long begin, long end) {
+      for (auto i = begin; i < end; i++) visits[i]++;
+    });
+    done.set_value();
+  });
+  done.get_future().wait();
+  for (int count : visits) EXPECT_EQ(count, 1);
+}
+
+TEST(thread_pool, short_task_passes_a_long_one) {
+  S21ThreadPool pool(2);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::promise<void> long_done, short_done;
+  pool.Submit([&] {
+    // holds its coordinator until the short task is through
+    released.wait_for(std::chrono::seconds(30));
+    long_done.set_value();
+  });
+  pool.Submit([&] {
+    pool.ParallelFor(100, 1, [](long, long) {});
+    short_done.set_value();
+  });
+  std::future<void> long_future = long_done.get_future();
+  EXPECT_EQ(short_done.get_future().wait_for(std::chrono::seconds(10)),
+            std::future_status::ready);
+  EXPECT_EQ(long_future.wait_for(std::chrono::seconds(0)),
+            std::future_status::timeout);
+  release.set_value();
+  long_future.wait();
+}
+
+TEST(numa, policies_allocate_zeroed_matrices) {
+  EXPECT_GE(S21Numa::NodeCount(), 1);
+  for (auto policy : {S21NumaPolicy::kInterleave, S21NumaPolicy::kFirstTouch}) {
+    S21Matrix::SetNumaPolicy(policy);
+    EXPECT_EQ(S21Matrix::GetNumaPolicy(), policy);
+    S21Matrix m(512, 512);
+    S21Matrix ones(512, 512);
+    for (int i = 0; i < 512; i++) ones(i, i) = 1.0;
+    EXPECT_DOUBLE_EQ(m(511, 511), 0.0);
+    m += ones;
+    S21Matrix copy(m);
+    EXPECT_TRUE(copy == ones);
+    EXPECT_DOUBLE_EQ(copy(300, 300), 1.0);
+  }
+  S21Matrix::SetNumaPolicy(S21NumaPolicy::kDefault);
+}
+
+#ifdef __linux__
+TEST(numa, default_policy_leaves_workers_unpinned) {
+  cpu_set_t start;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(start), &start), 0);
+  S21ThreadPool pool(2);
+  std::atomic<int> pinned{0};
+  pool.ParallelFor(2, 1, [&](long, long) {
+    cpu_set_t now;
+    sched_getaffinity(0, sizeof(now), &now);
+    if (!CPU_EQUAL(&now, &start)) pinned++;
+  });
+  EXPECT_EQ(pinned, 0);
+  // pinning and back again restores the cpus the workers started with
+  pool.SetPinned(true);
+  pool.ParallelFor(2, 1, [](long, long) {});
+  pool.SetPinned(false);
+  pool.ParallelFor(2, 1, [&](long, long) {
+    cpu_set_t now;
+    sched_getaffinity(0, sizeof(now), &now);
+    if (!CPU_EQUAL(&now, &start)) pinned++;
+  });
+  EXPECT_EQ(pinned, 0);
+}
+#endif
+
+TEST(numa, parallel_kernels_match_serial) {
+  S21Matrix a(300, 250), b(250, 260);
+  for (int i = 0; i < 300; i++)
+    for (int j = 0; j < 250; j++) a(i, j) = (i * 7 + j) % 13 - 6;
+  for (int i = 0; i < 250; i++)
+    for (int j = 0; j < 260; j++) b(i, j) = (i + j * 3) % 11 - 5;
+  S21Matrix c = a * b;
+  for (int i = 0; i < 300; i += 37)
+    for (int j = 0; j < 260; j += 29) {
+      double sum = 0;
+      for (int k = 0; k < 250; k++) sum += a(i, k) * b(k, j);
+      EXPECT_DOUBLE_EQ(c(i, j), sum);
+    }
+}
+
+TEST(builders, uninitialized_constructor) {
+  S21Matrix m(3, 2, S21Matrix::uninitialized);
+  EXPECT_EQ(m.GetRows(), 3);
+  EXPECT_EQ(m.GetCols(), 2);
+  m.Fill(2.5);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 2; j++) EXPECT_DOUBLE_EQ(m(i, j), 2.5);
+  EXPECT_ANY_THROW(S21Matrix(-1, 2, S21Matrix::uninitialized));
+  EXPECT_EQ(S21Matrix(0, 4, S21Matrix::uninitialized).UseCount(), 0);
+}
+
+TEST(builders, identity_and_generator) {
+  S21Matrix id = S21Matrix::Identity(300);
+  S21Matrix gen =
+      S21Matrix::FromGenerator(300, 300, [](int i, int j) { return i == j; });
+  EXPECT_TRUE(id == gen);
+  EXPECT_DOUBLE_EQ(id(299, 299), 1.0);
+  EXPECT_DOUBLE_EQ(id(0, 299), 0.0);
+
+  S21Matrix m = S21Matrix::FromGenerator(
+      2, 3, [](int i, int j) { return 10.0 * i + j; });
+  EXPECT_DOUBLE_EQ(m(1, 2), 12.0);
+  S21Matrix product = m * S21Matrix::Identity(3);
+  EXPECT_TRUE(product == m);
+}
+
+TEST(builders, random) {
+  S21Matrix a = S21Matrix::Random(400, 300, 42);
+  S21Matrix b = S21Matrix::Random(400, 300, 42);
+  S21Matrix c = S21Matrix::Random(400, 300, 43);
+  EXPECT_TRUE(a == b);
+  EXPECT_FALSE(a == c);
+  double mean = 0;
+  for (int i = 0; i < 400; i++)
+    for (int j = 0; j < 300; j++) {
+      EXPECT_GE(a(i, j), 0.0);
+      EXPECT_LT(a(i, j), 1.0);
+      mean += a(i, j);
+    }
+  EXPECT_NEAR(mean / (400 * 300), 0.5, 0.01);
+
+  S21Matrix normal =
+      S21Matrix::Random(200, 200, 7, S21Matrix::Distribution::kNormal);
+  double sum = 0, squares = 0;
+  for (int i = 0; i < 200; i++)
+    for (int j = 0; j < 200; j++) {
+      sum += normal(i, j);
+      squares += normal(i, j) * normal(i, j);
+    }
+  EXPECT_NEAR(sum / 40000, 0.0, 0.03);
+  EXPECT_NEAR(squares / 40000, 1.0, 0.05);
+}
+
+TEST(interop, adopt_unique_buffer) {
+  std::unique_ptr<double[]> buffer(new double[6]{1, 2, 3, 4, 5, 6});
+  double* raw = buffer.get();
+  S21Matrix m(std::move(buffer), 2, 3);
+  EXPECT_EQ(m.data(), raw);
+  EXPECT_DOUBLE_EQ(m(1, 0), 4);
+  EXPECT_TRUE(m.IsContiguous());
+  EXPECT_EQ(m.GetStride(), 3);
+
+  std::unique_ptr<double[]> columns(new double[6]{1, 4, 2, 5, 3, 6});
+  S21Matrix c(std::move(columns), 2, 3, S21Layout::kColMajor);
+  EXPECT_EQ(c.GetLayout(), S21Layout::kColMajor);
+  EXPECT_TRUE(c == m);
+  S21Matrix sum = c + m;
+  EXPECT_DOUBLE_EQ(sum(1, 2), 12);
+  S21Matrix copy(c);
+  EXPECT_EQ(copy.GetLayout(), S21Layout::kColMajor);
+  EXPECT_NE(copy.data(), c.data());
+  EXPECT_TRUE(copy == m);
+}
+
+TEST(interop, wrap_with_stride) {
+  // 2 x 3 row-major view with a padded leading dimension of 4
+  double buffer[8] = {1, 2, 3, -1, 4, 5, 6, -1};
+  S21MatrixView m = S21Matrix::Wrap(buffer, 2, 3, S21Layout::kRowMajor, 4);
+  EXPECT_FALSE(m.IsContiguous());
+  EXPECT_DOUBLE_EQ(m(1, 2), 6);
+  m(1, 2) = 60;
+  m.MulNumber(2);
+  EXPECT_DOUBLE_EQ(buffer[6], 120);
+  EXPECT_DOUBLE_EQ(buffer[3], -1);
+
+  m.SetShared(true);
+  S21Matrix copy(m);
+  EXPECT_EQ(copy.UseCount(), 1);
+  copy(0, 0) = 100;
+  EXPECT_DOUBLE_EQ(buffer[0], 2);
+  EXPECT_TRUE(copy.IsContiguous());
+
+  S21Matrix product = m * S21Matrix::Identity(3);
+  EXPECT_TRUE(product == m);
+  S21Matrix t = S21Matrix(m).Transpose();
+  EXPECT_DOUBLE_EQ(t(2, 1), 120);
+
+  EXPECT_THROW(S21Matrix::Wrap(buffer, 2, 3, S21Layout::kRowMajor, 2),
+               std::invalid_argument);
+  EXPECT_THROW(S21Matrix::Wrap(nullptr, 2, 3), std::invalid_argument);
+}
+
+TEST(interop, wrap_returns_a_view) {
+  static_assert(!std::is_copy_constructible<S21MatrixView>::value, "");
+  static_assert(!std::is_move_constructible<S21MatrixView>::value, "");
+  static_assert(!std::is_assignable<S21MatrixView&, S21Matrix>::value, "");
+  static_assert(!std::is_constructible<S21Matrix, S21MatrixView&&>::value,
+                "");
+  double buffer[4] = {1, 2, 3, 4};
+  S21MatrixView m = S21Matrix::Wrap(buffer, 2, 2);
+  // expiring views still leave the buffer to its owner
+  S21Matrix sum = std::move(m) + S21Matrix::Identity(2);
+  S21Matrix scaled = 2 * std::move(m);
+  S21Matrix t = std::move(m).Transpose();
+  buffer[1] = 20;
+  EXPECT_DOUBLE_EQ(sum(0, 0), 2);
+  EXPECT_DOUBLE_EQ(sum(0, 1), 2);
+  EXPECT_DOUBLE_EQ(scaled(0, 1), 4);
+  EXPECT_DOUBLE_EQ(t(1, 0), 2);
+  EXPECT_DOUBLE_EQ(m(0, 1), 20);
+  EXPECT_NE(sum.data(), buffer);
+}
+
+static S21Matrix take(S21Matrix&& matrix) { return std::move(matrix); }
+
+TEST(interop, moving_a_view_copies) {
+  double buffer[4] = {1, 2, 3, 4};
+  S21MatrixView m = S21Matrix::Wrap(buffer, 2, 2);
+  S21Matrix taken = take(std::move(m));
+  EXPECT_NE(taken.data(), buffer);
+  taken(0, 0) = 100;
+  EXPECT_DOUBLE_EQ(buffer[0], 1);
+  S21Matrix assigned;
+  assigned = std::move(static_cast<S21Matrix&>(m));
+  EXPECT_NE(assigned.data(), buffer);
+  EXPECT_EQ(m.data(), buffer);
+  EXPECT_DOUBLE_EQ(assigned(1, 1), 4);
+}
+
+TEST(interop, view_products_stay_in_the_buffer) {
+  double buffer[4] = {1, 2, 3, 4};
+  S21MatrixView m = S21Matrix::Wrap(buffer, 2, 2);
+  S21Matrix swap(2, 2);
+  swap(0, 1) = swap(1, 0) = 1;
+  m *= swap;
+  EXPECT_EQ(m.data(), buffer);
+  EXPECT_DOUBLE_EQ(buffer[0], 2);
+  EXPECT_DOUBLE_EQ(buffer[1], 1);
+  m(0, 1) = 99;
+  EXPECT_DOUBLE_EQ(buffer[1], 99);
+  m.SetRows(2);
+  EXPECT_EQ(m.data(), buffer);
+  EXPECT_THROW(m.SetRows(3), std::logic_error);
+  EXPECT_THROW(m.SetCols(1), std::logic_error);
+  EXPECT_THROW(m.MulMatrix(S21Matrix(2, 3)), std::logic_error);
+  EXPECT_DOUBLE_EQ(buffer[3], 3);
+}
+
+TEST(interop, shared_buffer_outlives_matrix) {
+  std::shared_ptr<double[]> buffer(new double[4]{1, 0, 0, 1});
+  {
+    S21Matrix m(buffer, 2, 2);
+    EXPECT_EQ(buffer.use_count(), 2);
+    EXPECT_TRUE(m == S21Matrix::Identity(2));
+  }
+  EXPECT_EQ(buffer.use_count(), 1);
+}
+
+static void countRelease(void* context) { ++*static_cast<int*>(context); }
+
+TEST(interop, c_api) {
+  double data[4] = {4, 7, 2, 6};
+  int released = 0;
+  s21_matrix* a = nullptr;
+  s21_matrix* b = nullptr;
+  s21_matrix* product = nullptr;
+  ASSERT_EQ(s21_matrix_adopt(data, 2, 2, S21_COL_MAJOR, 0, countRelease,
+                             &released, &a),
+            S21_OK);
+  ASSERT_EQ(s21_matrix_wrap(data, 2, 2, S21_ROW_MAJOR, 0, &b), S21_OK);
+  EXPECT_EQ(s21_matrix_layout(a), S21_COL_MAJOR);
+  EXPECT_EQ(s21_matrix_data(a), data);
+
+  double det = 0;
+  EXPECT_EQ(s21_matrix_determinant(a, &det), S21_OK);
+  EXPECT_DOUBLE_EQ(det, 10);
+  ASSERT_EQ(s21_matrix_mul(a, b, &product), S21_OK);
+  EXPECT_EQ(s21_matrix_rows(product), 2);
+  EXPECT_DOUBLE_EQ(s21_matrix_data(product)[0], 4 * 4 + 2 * 2);
+
+  s21_matrix* column = nullptr;
+  s21_matrix* failed = nullptr;
+  ASSERT_EQ(s21_matrix_create(3, 1, &column), S21_OK);
+  EXPECT_EQ(s21_matrix_mul(a, column, &failed), S21_SIZE_MISMATCH);
+  EXPECT_EQ(s21_matrix_create(-1, 1, &failed), S21_INVALID_ARGUMENT);
+  EXPECT_EQ(s21_matrix_inverse(column, &failed), S21_SIZE_MISMATCH);
+  s21_matrix* zero = nullptr;
+  ASSERT_EQ(s21_matrix_create(2, 2, &zero), S21_OK);
+  EXPECT_EQ(s21_matrix_inverse(zero, &failed), S21_CALCULATION_ERROR);
+  EXPECT_EQ(failed, nullptr);
+
+  s21_matrix_destroy(zero);
+  s21_matrix_destroy(column);
+  s21_matrix_destroy(product);
+  s21_matrix_destroy(b);
+  EXPECT_EQ(released, 0);
+  s21_matrix_destroy(a);
+  EXPECT_EQ(released, 1);
+  EXPECT_DOUBLE_EQ(data[1], 7);
+}
+
+TEST(layout, column_major_storage) {
+  S21Matrix m(2, 3, S21Layout::kColMajor);
+  m(0, 1) = 5;
+  m(1, 2) = 7;
+  EXPECT_EQ(m.GetLayout(), S21Layout::kColMajor);
+  EXPECT_EQ(m.GetStride(), 2);
+  EXPECT_DOUBLE_EQ(m.data()[2], 5);
+  EXPECT_DOUBLE_EQ(m.data()[5], 7);
+
+  S21Matrix row = m.ToLayout(S21Layout::kRowMajor);
+  EXPECT_EQ(row.GetLayout(), S21Layout::kRowMajor);
+  EXPECT_DOUBLE_EQ(row.data()[1], 5);
+  EXPECT_TRUE(row == m);
+  m.SetCols(4);
+  EXPECT_EQ(m.GetLayout(), S21Layout::kColMajor);
+  EXPECT_DOUBLE_EQ(m(1, 2), 7);
+  EXPECT_DOUBLE_EQ(m(1, 3), 0);
+}
+
+TEST(layout, transpose_is_a_view) {
+  S21Matrix m = S21Matrix::FromGenerator(
+      3, 4, [](int i, int j) { return 10.0 * i + j; });
+  m.SetShared(true);
+  long before = allocations;
+  S21Matrix t = m.Transpose();
+  EXPECT_EQ(allocations, before);
+  EXPECT_EQ(t.GetRows(), 4);
+  EXPECT_EQ(t.GetLayout(), S21Layout::kColMajor);
+  EXPECT_EQ(m.UseCount(), 2);
+  EXPECT_DOUBLE_EQ(t(3, 2), 23);
+
+  t(3, 2) = -1;
+  EXPECT_EQ(m.UseCount(), 1);
+  EXPECT_DOUBLE_EQ(m(2, 3), 23);
+  EXPECT_TRUE(t.Transpose().Transpose() == t);
+}
+
+TEST(layout, transpose_of_unshared_matrix_is_a_copy) {
+  S21Matrix m = S21Matrix::FromGenerator(
+      3, 4, [](int i, int j) { return 10.0 * i + j; });
+  double* elements = m.data();
+  S21Matrix t = m.Transpose();
+  EXPECT_EQ(t.GetLayout(), S21Layout::kColMajor);
+  EXPECT_EQ(m.UseCount(), 1);
+  elements[2 * 4 + 3] = -1;
+  EXPECT_DOUBLE_EQ(m(2, 3), -1);
+  EXPECT_DOUBLE_EQ(t(3, 2), 23);
+}
+
+TEST(layout, mul_all_layout_combinations) {
+  S21Matrix a = S21Matrix::Random(37, 29, 1);
+  S21Matrix b = S21Matrix::Random(29, 41, 2);
+  S21Matrix expected(37, 41);
+  for (int i = 0; i < 37; i++)
+    for (int j = 0; j < 41; j++)
+      for (int k = 0; k < 29; k++) expected(i, j) += a(i, k) * b(k, j);
+
+  for (auto a_layout : {S21Layout::kRowMajor, S21Layout::kColMajor}) {
+    for (auto b_layout : {S21Layout::kRowMajor, S21Layout::kColMajor}) {
+      S21Matrix product = a.ToLayout(a_layout) * b.ToLayout(b_layout);
+      EXPECT_TRUE(product == expected);
+      S21Matrix sum = a.ToLayout(a_layout) + a.ToLayout(b_layout);
+      EXPECT_TRUE(sum == a * 2.0);
+    }
+  }
+  S21Matrix transposed_product = b.Transpose() * a.Transpose();
+  EXPECT_TRUE(transposed_product == expected.Transpose());
+}
+
+TEST(lu, solve_and_determinant) {
+  S21Matrix a(3, 3);
+  a(0, 0) = 2;
+  a(0, 1) = 3;
+  a(0, 2) = 1;
+  a(1, 0) = 7;
+  a(1, 1) = 4;
+  a(1, 2) = 1;
+  a(2, 0) = 9;
+  a(2, 1) = -2;
+  a(2, 2) = 1;
+  S21LU lu(a);
+  EXPECT_NEAR(lu.Determinant(), -32, 1e-12);
+  S21Matrix b = S21Matrix::Random(3, 2, 5);
+  EXPECT_TRUE(a * lu.Solve(b) == b);
+  EXPECT_TRUE(lu.SolveTransposed(b.Transpose()) * a == b.Transpose());
+  EXPECT_TRUE(lu.Inverse() == a.InverseMatrix());
+
+  S21LU singular(S21Matrix(3, 3));
+  EXPECT_TRUE(singular.IsSingular());
+  EXPECT_DOUBLE_EQ(singular.Determinant(), 0);
+  EXPECT_THROW(singular.Solve(b), std::logic_error);
+  EXPECT_THROW(S21LU(S21Matrix(2, 3)), std::logic_error);
+}
+
+TEST(factor_cache, rank_one_updates) {
+  const int n = 40;
+  S21Matrix a = S21Matrix::Random(n, n, 11) + S21Matrix::Identity(n) * n;
+  S21MatrixFactorCache cache(a);
+
+  cache.SetElement(3, 5, 17.0);
+  a(3, 5) = 17.0;
+  S21Matrix row = S21Matrix::Random(1, n, 12);
+  cache.SetRow(7, row);
+  for (int j = 0; j < n; j++) a(7, j) = row(0, j);
+  S21Matrix col = S21Matrix::Random(n, 1, 13);
+  cache.SetColumn(9, col);
+  for (int i = 0; i < n; i++) a(i, 9) = col(i, 0);
+
+  EXPECT_EQ(cache.GetUpdatesSinceFactorization(), 3);
+  EXPECT_TRUE(cache.GetMatrix() == a);
+  S21LU fresh(a);
+  EXPECT_NEAR(cache.Determinant() / fresh.Determinant(), 1.0, 1e-9);
+  EXPECT_TRUE(cache.InverseMatrix() == fresh.Inverse());
+}
+
+TEST(factor_cache, rank_k_update_and_refactorization) {
+  const int n = 30;
+  S21Matrix a = S21Matrix::Random(n, n, 21) + S21Matrix::Identity(n) * n;
+  S21MatrixFactorCache cache(a);
+  S21Matrix u = S21Matrix::Random(n, 3, 22);
+  S21Matrix v = S21Matrix::Random(n, 3, 23);
+  cache.Update(u, v);
+  S21Matrix updated = a + u * v.Transpose();
+  EXPECT_TRUE(cache.InverseMatrix() * updated == S21Matrix::Identity(n));
+  EXPECT_NEAR(cache.Determinant() / S21LU(updated).Determinant(), 1.0, 1e-9);
+  EXPECT_THROW(cache.Update(u, S21Matrix(n, 2)), std::logic_error);
+
+  // zeroing a row makes the matrix singular and forces a refactorization
+  cache.SetRow(0, S21Matrix(1, n));
+  EXPECT_EQ(cache.GetUpdatesSinceFactorization(), 0);
+  EXPECT_DOUBLE_EQ(cache.Determinant(), 0);
+  EXPECT_THROW(cache.InverseMatrix(), std::logic_error);
+  cache.SetRow(0, S21Matrix::Random(1, n, 24));
+  EXPECT_NE(cache.Determinant(), 0);
+  EXPECT_TRUE(cache.InverseMatrix() * cache.GetMatrix() ==
+              S21Matrix::Identity(n));
+  EXPECT_THROW(cache.SetElement(n, 0, 1.0), std::out_of_range);
+}
+
+TEST(factor_cache, small_capacitance_determinant_is_not_singular) {
+  // scaling four columns by 1e-3 gives det(C) = 1e-12, a well-conditioned
+  // update all the same
+  const int n = 20;
+  S21Matrix a = S21Matrix::Random(n, n, 25) + S21Matrix::Identity(n) * n;
+  S21Matrix u(n, 4), v(n, 4);
+  for (int j = 0; j < 4; j++) {
+    for (int i = 0; i < n; i++) u(i, j) = -0.999 * a(i, j);
+    v(j, j) = 1;
+  }
+  S21MatrixFactorCache cache(a);
+  cache.Update(u, v);
+  EXPECT_EQ(cache.GetUpdatesSinceFactorization(), 1);
+  S21Matrix updated = a + u * v.Transpose();
+  EXPECT_NEAR(cache.Determinant() / S21LU(updated).Determinant(), 1.0, 1e-9);
+  EXPECT_TRUE(cache.InverseMatrix() * updated == S21Matrix::Identity(n));
+}
+
+TEST(equality, shape_mismatch_in_one_dimension) {
+  S21Matrix a(2, 3);
+  S21Matrix b(3, 3);
+  S21Matrix c(2, 4);
+  EXPECT_FALSE(a == b);
+  EXPECT_FALSE(b == a);
+  EXPECT_FALSE(a == c);
+  EXPECT_FALSE(a == S21Matrix());
+  EXPECT_TRUE(S21Matrix() == S21Matrix(0, 0));
+}
+
+TEST(equality, tolerance_modes) {
+  S21Matrix a = S21Matrix::Random(20, 20, 3) * 1e6;
+  S21Matrix b(a);
+  b(19, 19) += 1e-3;
+  EXPECT_FALSE(a == b);
+
+  S21EqualityPolicy relative;
+  relative.absolute = 0.0;
+  relative.relative = 1e-6;
+  EXPECT_TRUE(a.EqMatrix(b, relative));
+  relative.relative = 1e-15;
+  EXPECT_FALSE(a.EqMatrix(b, relative));
+
+  S21Matrix c(a);
+  c(5, 5) = std::nextafter(std::nextafter(a(5, 5), 1e300), 1e300);
+  S21EqualityPolicy ulps;
+  ulps.absolute = 0.0;
+  ulps.ulps = 2;
+  EXPECT_TRUE(a.EqMatrix(c, ulps));
+  ulps.ulps = 1;
+  EXPECT_FALSE(a.EqMatrix(c, ulps));
+
+  S21Matrix nan(1, 1);
+  nan(0, 0) = std::nan("");
+  EXPECT_FALSE(nan == nan.ToLayout(S21Layout::kColMajor));
+  // a copy-on-write copy shares the NaN and still differs from it
+  nan.SetShared(true);
+  S21Matrix nan_copy(nan);
+  EXPECT_EQ(nan.UseCount(), 2);
+  EXPECT_FALSE(nan == nan_copy);
+  EXPECT_FALSE(nan == nan);
+  S21Matrix inf(1, 1);
+  inf(0, 0) = HUGE_VAL;
+  EXPECT_TRUE(inf == S21Matrix(inf).ToLayout(S21Layout::kColMajor));
+}
+
+TEST(equality, hash_for_unordered_containers) {
+  S21Matrix a = S21Matrix::Random(4, 5, 1);
+  S21Matrix same = a.ToLayout(S21Layout::kColMajor);
+  S21Matrix zero(2, 2);
+  S21Matrix negative_zero(2, 2);
+  negative_zero(1, 1) = -0.0;
+  S21MatrixHash hash;
+  EXPECT_EQ(hash(a), hash(same));
+  EXPECT_EQ(hash(zero), hash(negative_zero));
+  EXPECT_NE(hash(S21Matrix(2, 3)), hash(S21Matrix(3, 2)));
+
+  std::unordered_set<S21Matrix, S21MatrixHash, S21MatrixExactEqual> cache;
+  cache.insert(a);
+  cache.insert(same);
+  cache.insert(zero);
+  cache.insert(negative_zero);
+  cache.insert(a.Transpose());
+  EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(power, binary_exponentiation) {
+  S21Matrix a = S21Matrix::Random(6, 6, 8) * 0.5;
+  S21Matrix expected = S21Matrix::Identity(6);
+  for (int k = 1; k <= 13; k++) {
+    expected *= a;
+    EXPECT_TRUE(a.Pow(k) == expected);
+  }
+  EXPECT_TRUE(a.Pow(0) == S21Matrix::Identity(6));
+  S21Matrix inverse = a.InverseMatrix();
+  EXPECT_TRUE(a.Pow(-3) == inverse * inverse * inverse);
+  EXPECT_THROW(S21Matrix(2, 3).Pow(2), std::logic_error);
+
+  S21Matrix fibonacci(2, 2);
+  fibonacci(0, 0) = 1;
+  fibonacci(0, 1) = 1;
+  fibonacci(1, 0) = 1;
+  EXPECT_DOUBLE_EQ(fibonacci.Pow(50)(0, 1), 12586269025.0);
+}
+
+TEST(power, buffers_are_reused) {
+  S21Matrix a = S21Matrix::Identity(8) * 1.0001;
+  long before = allocations;
+  S21Matrix p = a.Pow(1000000);
+  EXPECT_LE(allocations - before, 4);
+  EXPECT_NEAR(p(3, 3), std::pow(1.0001, 1000000), 1e-6 * p(3, 3));
+}
+
+TEST(power, exponential) {
+  EXPECT_TRUE(S21Matrix(3, 3).Exp() == S21Matrix::Identity(3));
+
+  S21Matrix nilpotent(2, 2);
+  nilpotent(0, 1) = 1;
+  S21Matrix expected = S21Matrix::Identity(2);
+  expected(0, 1) = 1;
+  EXPECT_TRUE(nilpotent.Exp() == expected);
+
+  // a large rotation generator needs several squarings
+  S21Matrix rotation(2, 2);
+  rotation(0, 1) = -20;
+  rotation(1, 0) = 20;
+  S21Matrix r = rotation.Exp();
+  EXPECT_NEAR(r(0, 0), std::cos(20.0), 1e-11);
+  EXPECT_NEAR(r(1, 0), std::sin(20.0), 1e-11);
+
+  S21Matrix diagonal(3, 3);
+  diagonal(0, 0) = -1;
+  diagonal(1, 1) = 0.5;
+  diagonal(2, 2) = 3;
+  S21Matrix d = diagonal.Exp();
+  EXPECT_NEAR(d(0, 0), std::exp(-1.0), 1e-14);
+  EXPECT_NEAR(d(2, 2), std::exp(3.0), 1e-12);
+  EXPECT_NEAR(d(0, 2), 0, 1e-15);
+
+  S21Matrix a = S21Matrix::Random(5, 5, 9);
+  EXPECT_TRUE(a.Exp() * (a * -1.0).Exp() == S21Matrix::Identity(5));
+  EXPECT_THROW(S21Matrix(1, 2).Exp(), std::logic_error);
+}
+
+TEST(structured, symmetric) {
+  S21Matrix a = S21Matrix::Random(7, 4, 10);
+  S21SymmetricMatrix s = S21SymmetricMatrix::Syrk(a, 2.0);
+  EXPECT_EQ(s.GetSize(), 7);
+  EXPECT_TRUE(s.ToDense() == a * a.Transpose() * 2.0);
+
+  s(1, 5) = 3;
+  EXPECT_DOUBLE_EQ(s(5, 1), 3);
+  S21Matrix b = S21Matrix::Random(7, 3, 11);
+  EXPECT_TRUE(s.Multiply(b) == s.ToDense() * b);
+  EXPECT_TRUE(S21SymmetricMatrix::FromDense(s.ToDense()).ToDense() ==
+              s.ToDense());
+  EXPECT_THROW(s(7, 0), std::out_of_range);
+  EXPECT_THROW(s.Multiply(S21Matrix(6, 2)), std::logic_error);
+}
+
+TEST(structured, triangular) {
+  S21Matrix a = S21Matrix::Random(6, 6, 12) + S21Matrix::Identity(6) * 4.0;
+  for (auto triangle : {S21Triangle::kLower, S21Triangle::kUpper}) {
+    S21TriangularMatrix t = S21TriangularMatrix::FromDense(a, triangle);
+    S21Matrix dense = t.ToDense();
+    const S21TriangularMatrix& view = t;
+    EXPECT_DOUBLE_EQ(view(triangle == S21Triangle::kLower ? 0 : 5,
+                          triangle == S21Triangle::kLower ? 5 : 0),
+                     0);
+    EXPECT_NEAR(t.Determinant(), dense.Determinant(), 1e-9);
+
+    S21Matrix b = S21Matrix::Random(6, 3, 13);
+    EXPECT_TRUE(t.Multiply(b) == dense * b);
+    EXPECT_TRUE(dense * t.Solve(b) == b);
+  }
+  S21TriangularMatrix upper(3, S21Triangle::kUpper);
+  EXPECT_THROW(upper(2, 1) = 1, std::out_of_range);
+  EXPECT_THROW(upper.Solve(S21Matrix(3, 1)), std::logic_error);
+}
+
+TEST(structured, band) {
+  const int n = 40;
+  S21BandMatrix band(n, 2, 1);
+  for (int i = 0; i < n; i++) {
+    for (int j = std::max(0, i - 2); j <= std::min(n - 1, i + 1); j++) {
+      band(i, j) = std::sin(i * 7.0 + j);
+    }
+  }
+  EXPECT_THROW(band(0, 2) = 1, std::out_of_range);
+  const S21BandMatrix& view = band;
+  EXPECT_DOUBLE_EQ(view(0, 2), 0);
+  S21Matrix dense = band.ToDense();
+  S21Matrix b = S21Matrix::Random(n, 2, 14);
+  EXPECT_TRUE(band.Multiply(b) == dense * b);
+  // pivoting has to fill in past the upper bandwidth
+  EXPECT_TRUE(dense * band.Solve(b) == b);
+  EXPECT_NEAR(band.Determinant(), S21LU(dense).Determinant(),
+              1e-9 * std::fabs(band.Determinant()));
+  EXPECT_TRUE(S21BandMatrix::FromDense(dense, 2, 1).ToDense() == dense);
+
+  S21BandMatrix singular(3, 1, 1);
+  singular(0, 0) = 1;
+  singular(1, 1) = 1;
+  EXPECT_DOUBLE_EQ(singular.Determinant(), 0);
+  EXPECT_THROW(singular.Solve(S21Matrix(3, 1)), std::logic_error);
+}
+
+TEST(structured, dense_triangular_determinant) {
+  // Laplace expansion would take 20! steps
+  S21Matrix a = S21Matrix::Identity(20) * 2.0;
+  a(3, 17) = 5;
+  EXPECT_DOUBLE_EQ(a.Determinant(), std::pow(2.0, 20));
+  EXPECT_DOUBLE_EQ(a.Transpose().Determinant(), std::pow(2.0, 20));
+}
+
+TEST(structured, dense_general_determinant) {
+  // one entry below and one above the diagonal, elimination takes over
+  S21Matrix a = S21Matrix::Identity(30) * 2.0;
+  a(3, 17) = 5;
+  a(29, 0) = 1;
+  EXPECT_NEAR(a.Determinant() / std::pow(2.0, 30), 1.0, 1e-12);
+  S21Matrix b = S21Matrix::Random(40, 40, 21);
+  EXPECT_NEAR(b.Determinant(), b.DeterminantAsync().get(),
+              1e-12 * std::fabs(b.Determinant()));
+  S21Matrix empty;
+  EXPECT_DOUBLE_EQ(empty.Determinant(), 1);
+  EXPECT_DOUBLE_EQ(empty.DeterminantAsync().get(), 1);
+  EXPECT_DOUBLE_EQ(S21LU(empty).Determinant(), 1);
+}
+
+TEST(async, results_match) {
+  S21Matrix a = S21Matrix::Random(300, 200, 15);
+  S21Matrix b = S21Matrix::Random(200, 150, 16).Transpose().Transpose();
+  std::future<S21Matrix> product = a.MulMatrixAsync(b);
+  // the operands were copied
+  a.Fill(0);
+  EXPECT_TRUE(product.get() == S21Matrix::Random(300, 200, 15) * b);
+  EXPECT_THROW(a.MulMatrixAsync(a), std::logic_error);
+
+  S21Matrix c = S21Matrix::Random(120, 120, 17).ToLayout(S21Layout::kColMajor);
+  EXPECT_TRUE(c.InverseMatrixAsync().get() * c == S21Matrix::Identity(120));
+  EXPECT_NEAR(c.DeterminantAsync().get(), S21LU(c).Determinant(),
+              1e-12 * std::fabs(S21LU(c).Determinant()));
+  EXPECT_TRUE(c.Transpose().MulMatrixAsync(c).get() == c.Transpose() * c);
+
+  S21Matrix singular(3, 3);
+  std::future<S21Matrix> failed = singular.InverseMatrixAsync();
+  EXPECT_THROW(failed.get(), std::logic_error);
+  EXPECT_THROW(S21Matrix(2, 3).DeterminantAsync(), std::logic_error);
+}
+
+TEST(async, progress_and_cancellation) {
+  S21Matrix a = S21Matrix::Random(200, 200, 18);
+  std::vector<double> reports;
+  S21TaskControl progress(
+      [&](double fraction) { reports.push_back(fraction); });
+  a.InverseMatrixAsync(progress).get();
+  ASSERT_GT(reports.size(), 200u);
+  EXPECT_DOUBLE_EQ(reports.front(), 0.0);
+  EXPECT_DOUBLE_EQ(reports.back(), 1.0);
+  EXPECT_TRUE(std::is_sorted(reports.begin(), reports.end()));
+
+  S21CancellationToken token;
+  token.Cancel();
+  EXPECT_THROW(a.MulMatrixAsync(a, S21TaskControl(token)).get(),
+               S21Cancelled);
+
+  // cancelled from inside, halfway through the elimination
+  S21CancellationToken deadline;
+  double last = 0;
+  S21TaskControl control(deadline, [&](double fraction) {
+    last = fraction;
+    if (fraction >= 0.5) deadline.Cancel();
+  });
+  EXPECT_THROW(a.DeterminantAsync(control).get(), S21Cancelled);
+  EXPECT_LT(last, 0.6);
+  EXPECT_TRUE(deadline.IsCancelled());
+}
+
+TEST(tiled, graph_orders_tasks_by_data) {
+  for (auto schedule : {S21Schedule::kDataflow, S21Schedule::kForkJoin}) {
+    S21TileGraph graph(schedule);
+    std::vector<int> values(4);
+    std::atomic<int> wrong{0};
+    // a chain through tile 0 and independent tasks on tiles 1..3
+    for (int step = 0; step < 50; step++) {
+      graph.AddTask([&, step] {
+        if (values[0] != step) wrong++;
+        values[0]++;
+      }, {}, {0});
+      graph.AddTask([&, step] {
+        if (values[0] < step + 1) wrong++;
+      }, {0}, {});
+      graph.AddTask([&, step] { values[1 + step % 3]++; }, {},
+                    {1 + step % 3}, step);
+      graph.Barrier();
+    }
+    EXPECT_GE(graph.TaskCount(), 150);
+    graph.Run();
+    EXPECT_EQ(graph.TaskCount(), 0);
+    EXPECT_EQ(wrong, 0);
+    EXPECT_EQ(values[0], 50);
+    EXPECT_EQ(values[1] + values[2] + values[3], 50);
+
+    graph.AddTask([] {}, {}, {0});
+    graph.AddTask([] { throw std::runtime_error("task failed"); }, {0}, {});
+    EXPECT_THROW(graph.Run(), std::runtime_error);
+  }
+}
+
+TEST(tiled, lu_matches_unblocked) {
+  S21Matrix a = S21Matrix::Random(150, 150, 19);
+  S21LU reference(a);
+  for (auto schedule : {S21Schedule::kDataflow, S21Schedule::kForkJoin}) {
+    for (int tile : {1, 32, 64, 200}) {
+      S21LU lu(a, tile, schedule);
+      EXPECT_TRUE(lu.GetFactors().EqMatrix(reference.GetFactors(),
+                                           {1e-10, 1e-10, 0}));
+      EXPECT_EQ(lu.GetPivots(), reference.GetPivots());
+      EXPECT_NEAR(lu.Determinant(), reference.Determinant(),
+                  1e-9 * std::fabs(reference.Determinant()));
+    }
+  }
+  S21Matrix singular = S21Matrix::Random(40, 40, 20);
+  for (int i = 0; i < 40; i++) singular(i, 7) = 0;
+  EXPECT_TRUE(S21LU(singular, 16).IsSingular());
+  EXPECT_THROW(S21LU(a, 0), std::invalid_argument);
+  EXPECT_THROW(S21LU(S21Matrix(2, 3), 8), std::logic_error);
+}
+
+TEST(tiled, cholesky) {
+  S21Matrix b = S21Matrix::Random(130, 130, 21);
+  S21Matrix a = b * b.Transpose() + S21Matrix::Identity(130) * 130.0;
+  for (auto schedule : {S21Schedule::kDataflow, S21Schedule::kForkJoin}) {
+    for (int tile : {1, 16, 48, 128, 500}) {
+      S21Cholesky cholesky(a, tile, schedule);
+      const S21Matrix& l = cholesky.GetFactor();
+      EXPECT_DOUBLE_EQ(l(3, 100), 0);
+      EXPECT_TRUE(l * l.Transpose() == a);
+    }
+  }
+  S21Cholesky cholesky(a);
+  S21Matrix rhs = S21Matrix::Random(130, 2, 22);
+  EXPECT_TRUE(a * cholesky.Solve(rhs) == rhs);
+  EXPECT_NEAR(cholesky.Determinant() / S21LU(a).Determinant(), 1.0, 1e-9);
+
+  S21Matrix indefinite = S21Matrix::Identity(50);
+  indefinite(40, 40) = -1;
+  EXPECT_THROW(S21Cholesky(indefinite, 8), std::logic_error);
+  EXPECT_THROW(S21Cholesky(S21Matrix(2, 3)), std::logic_error);
+}
+
+TEST(stats, fused_pass_matches_loops) {
+  S21Matrix a = S21Matrix::Random(37, 23, 23, S21Matrix::Distribution::kNormal);
+  for (auto layout : {S21Layout::kRowMajor, S21Layout::kColMajor}) {
+    S21Matrix m = a.ToLayout(layout);
+    S21MatrixStats stats = m.Stats();
+    double sum = 0, squares = 0, trace = 0, norm1 = 0, norm_inf = 0;
+    double low = a(0, 0), high = a(0, 0);
+    for (int i = 0; i < 37; i++) {
+      double row = 0, row_abs = 0;
+      for (int j = 0; j < 23; j++) {
+        row += a(i, j);
+        row_abs += std::fabs(a(i, j));
+        squares += a(i, j) * a(i, j);
+        low = std::min(low, a(i, j));
+        high = std::max(high, a(i, j));
+      }
+      if (i < 23) trace += a(i, i);
+      EXPECT_NEAR(stats.row_sums(i, 0), row, 1e-12);
+      sum += row;
+      norm_inf = std::max(norm_inf, row_abs);
+    }
+    for (int j = 0; j < 23; j++) {
+      double col = 0, col_abs = 0;
+      for (int i = 0; i < 37; i++) {
+        col += a(i, j);
+        col_abs += std::fabs(a(i, j));
+      }
+      EXPECT_NEAR(stats.col_sums(0, j), col, 1e-12);
+      norm1 = std::max(norm1, col_abs);
+    }
+    EXPECT_NEAR(stats.sum, sum, 1e-11);
+    EXPECT_NEAR(stats.mean, sum / (37 * 23), 1e-14);
+    EXPECT_DOUBLE_EQ(stats.min, low);
+    EXPECT_DOUBLE_EQ(stats.max, high);
+    EXPECT_NEAR(stats.frobenius, std::sqrt(squares), 1e-12);
+    EXPECT_NEAR(stats.norm1, norm1, 1e-12);
+    EXPECT_NEAR(stats.norm_inf, norm_inf, 1e-12);
+    EXPECT_NEAR(stats.trace, trace, 1e-12);
+    EXPECT_NEAR(m.Transpose().Norm1(), stats.norm_inf, 1e-12);
+    EXPECT_EQ(m.RowSums().GetRows(), 37);
+    EXPECT_EQ(m.ColSums().GetCols(), 23);
+    // the narrow kernels add in the same order as the fused pass
+    S21EqualityPolicy exact{0.0, 0.0, 0};
+    EXPECT_EQ(m.Sum(), stats.sum);
+    EXPECT_EQ(m.Mean(), stats.mean);
+    EXPECT_EQ(m.Min(), stats.min);
+    EXPECT_EQ(m.Max(), stats.max);
+    EXPECT_EQ(m.FrobeniusNorm(), stats.frobenius);
+    EXPECT_EQ(m.Norm1(), stats.norm1);
+    EXPECT_EQ(m.NormInf(), stats.norm_inf);
+    EXPECT_TRUE(m.RowSums().EqMatrix(stats.row_sums, exact));
+    EXPECT_TRUE(m.ColSums().EqMatrix(stats.col_sums, exact));
+  }
+  EXPECT_THROW(a.Trace(), std::logic_error);
+  EXPECT_DOUBLE_EQ(S21Matrix::Identity(5).Trace(), 5);
+
+  S21MatrixStats empty = S21Matrix(0, 3).Stats();
+  EXPECT_TRUE(std::isnan(empty.mean));
+  EXPECT_GT(empty.min, empty.max);
+  EXPECT_DOUBLE_EQ(empty.col_sums(0, 2), 0);
+  S21Matrix none(0, 3);
+  EXPECT_TRUE(std::isnan(none.Mean()));
+  EXPECT_GT(none.Min(), none.Max());
+  EXPECT_DOUBLE_EQ(none.ColSums()(0, 2), 0);
+  EXPECT_DOUBLE_EQ(none.Norm1(), 0);
+}
+
+TEST(stats, compensated_summation) {
+  // the ones vanish next to 1e16 in naive summation
+  S21Matrix m(1000, 101);
+  for (int i = 0; i < 1000; i++) {
+    m(i, 0) = 1e16;
+    for (int j = 1; j < 101; j++) m(i, j) = 1.0;
+    m(i, 100) = -1e16;
+  }
+  EXPECT_DOUBLE_EQ(m.Sum(), 1000 * 99);
+  EXPECT_DOUBLE_EQ(m.RowSums()(999, 0), 99);
+  EXPECT_DOUBLE_EQ(m.Mean(), 99.0 / 101);
+  EXPECT_DOUBLE_EQ(m.Max(), 1e16);
+  EXPECT_DOUBLE_EQ(m.Min(), -1e16);
+  // the same sums taken across the lines of the transpose
+  EXPECT_DOUBLE_EQ(m.Transpose().ColSums()(0, 999), 99);
+}
+
+TEST(stats, nan_propagates) {
+  S21Matrix a = S21Matrix::Random(9, 7, 7);
+  a(5, 3) = std::numeric_limits<double>::quiet_NaN();
+  for (auto layout : {S21Layout::kRowMajor, S21Layout::kColMajor}) {
+    S21Matrix m = a.ToLayout(layout);
+    S21MatrixStats stats = m.Stats();
+    EXPECT_TRUE(std::isnan(m.Min()));
+    EXPECT_TRUE(std::isnan(m.Max()));
+    EXPECT_TRUE(std::isnan(m.Norm1()));
+    EXPECT_TRUE(std::isnan(m.NormInf()));
+    EXPECT_TRUE(std::isnan(m.Sum()));
+    EXPECT_TRUE(std::isnan(stats.min));
+    EXPECT_TRUE(std::isnan(stats.max));
+    EXPECT_TRUE(std::isnan(stats.norm1));
+    EXPECT_TRUE(std::isnan(stats.norm_inf));
+    EXPECT_TRUE(std::isnan(stats.col_sums(0, 3)));
+    EXPECT_FALSE(std::isnan(stats.col_sums(0, 2)));
+  }
+}
+
+TEST(condition, estimate_brackets_exact_value) {
+  for (int n : {1, 2, 8, 40}) {
+    S21Matrix hilbert = S21Matrix::FromGenerator(
+        n, n, [](int i, int j) { return 1.0 / (i + j + 1); });
+    S21Matrix random = S21Matrix::Random(n, n, 24 + n);
+    for (const S21Matrix* a : {&hilbert, &random}) {
+      S21LU lu(*a);
+      double exact = lu.Inverse().Norm1();
+      double estimate = lu.InverseNorm1Estimate();
+      EXPECT_LE(estimate, exact * (1 + 1e-10));
+      EXPECT_GE(estimate, exact / 3);
+      EXPECT_NEAR(lu.Norm1(), a->Norm1(), 1e-14 * a->Norm1());
+    }
+  }
+  S21Matrix hilbert = S21Matrix::FromGenerator(
+      8, 8, [](int i, int j) { return 1.0 / (i + j + 1); });
+  // kappa_1 of the 8 x 8 Hilbert matrix is about 3.4e10
+  EXPECT_NEAR(std::log10(1 / hilbert.Rcond()), 10.5, 0.5);
+  EXPECT_FALSE(S21LU(hilbert).IsSingular(1e-16));
+  EXPECT_TRUE(S21LU(hilbert).IsSingular(1e-8));
+  EXPECT_FALSE(hilbert.IsSingular(1e-16));
+  EXPECT_TRUE(hilbert.IsSingular(1e-8));
+  EXPECT_TRUE(S21Matrix(3, 3).IsSingular(1e-16));
+  EXPECT_THROW(S21Matrix(2, 3).IsSingular(1e-16), std::logic_error);
+}
+
+TEST(condition, singularity_does_not_depend_on_scale) {
+  S21Matrix a = S21Matrix::Random(6, 6, 25);
+  for (double scale : {1e-30, 1e-3, 1.0, 1e30}) {
+    S21Matrix scaled = a * scale;
+    EXPECT_NEAR(scaled.Rcond(), a.Rcond(), 1e-12);
+    EXPECT_TRUE(scaled.InverseMatrix() * scaled == S21Matrix::Identity(6));
+  }
+  S21Matrix small = S21Matrix::Identity(5) * 1e-3;
+  EXPECT_TRUE(small.InverseMatrix() == S21Matrix::Identity(5) * 1e3);
+
+  S21Matrix singular = S21Matrix::FromGenerator(
+      3, 3, [](int i, int j) { return 3.0 * i + j + 1; });
+  EXPECT_THROW(singular.InverseMatrix(), std::logic_error);
+  EXPECT_THROW((singular * 1e20).InverseMatrix(), std::logic_error);
+  EXPECT_TRUE(S21LU(singular).IsSingular(1e-15));
+  EXPECT_DOUBLE_EQ(S21Matrix(4, 4).Rcond(), 0);
+  EXPECT_DOUBLE_EQ(S21Matrix::Identity(4).Rcond(), 1);
+}
+
+TEST(condition, rank) {
+  S21Matrix u = S21Matrix::Random(7, 2, 26);
+  S21Matrix v = S21Matrix::Random(2, 5, 27);
+  EXPECT_EQ((u * v).Rank(), 2);
+  EXPECT_EQ((u * v).Transpose().Rank(), 2);
+  EXPECT_EQ(S21Matrix::Random(7, 5, 28).Rank(), 5);
+  EXPECT_EQ(S21Matrix(3, 4).Rank(), 0);
+  EXPECT_EQ(S21Matrix().Rank(), 0);
+  S21Matrix nearly = S21Matrix::Identity(3);
+  nearly(2, 2) = 1e-9;
+  EXPECT_EQ(nearly.Rank(), 3);
+  EXPECT_EQ(nearly.Rank(1e-6), 2);
+}
+
+TEST(distributed, grid_and_collectives) {
+  S21LocalTransport::Run(6, [](S21Transport& transport) {
+    S21ProcessGrid grid(transport);
+    EXPECT_EQ(grid.GetRows(), 2);
+    EXPECT_EQ(grid.GetCols(), 3);
+    EXPECT_EQ(grid.RankOf(grid.GetRow(), grid.GetCol()), transport.Rank());
+    EXPECT_THROW(S21ProcessGrid(transport, 4, 2), std::invalid_argument);
+
+    std::vector<double> row;
+    if (grid.GetCol() == 1) row = {1.0 * grid.GetRow(), 7};
+    grid.BroadcastRow(1, row, 5);
+    EXPECT_EQ(row, std::vector<double>({1.0 * grid.GetRow(), 7}));
+    std::vector<double> all;
+    if (transport.Rank() == 4) all = {4, 2};
+    grid.Broadcast(4, all, 6);
+    EXPECT_EQ(all, std::vector<double>({4, 2}));
+    auto ranks = grid.AllGather({1.0 * transport.Rank()}, 7);
+    for (auto rank = 0; rank < 6; rank++) EXPECT_EQ(ranks[rank][0], rank);
+    auto column = grid.AllGatherCol({1.0 * grid.GetRow()}, 8);
+    EXPECT_EQ(column, std::vector<std::vector<double>>({{0}, {1}}));
+    grid.Barrier();
+  });
+}
+
+TEST(distributed, scatter_and_gather) {
+  S21Matrix a = S21Matrix::Random(7, 5, 40);
+  for (auto shape : {std::make_pair(2, 2), std::make_pair(1, 3)}) {
+    S21LocalTransport::Run(
+        shape.first * shape.second, [&](S21Transport& transport) {
+          S21ProcessGrid grid(transport, shape.first, shape.second);
+          auto d = S21DistributedMatrix::Scatter(
+              grid, transport.Rank() == 0 ? a : S21Matrix(), 3);
+          EXPECT_EQ(d.GetRows(), 7);
+          EXPECT_EQ(d.GetCols(), 5);
+          auto generated = S21DistributedMatrix::FromGenerator(
+              grid, 7, 5, 3, [&a](int i, int j) { return a(i, j); });
+          EXPECT_TRUE(generated.GetLocal() == d.GetLocal());
+          S21Matrix whole = d.Gather();
+          if (transport.Rank() == 0) {
+            EXPECT_TRUE(whole == a);
+          } else {
+            EXPECT_EQ(whole.GetRows(), 0);
+          }
+        });
+  }
+}
+
+TEST(distributed, summa_matches_serial_product) {
+  S21Matrix a = S21Matrix::Random(9, 7, 41);
+  S21Matrix b = S21Matrix::Random(7, 8, 42);
+  for (auto shape : {std::make_pair(2, 2), std::make_pair(1, 3),
+                     std::make_pair(3, 1)}) {
+    S21LocalTransport::Run(
+        shape.first * shape.second, [&](S21Transport& transport) {
+          S21ProcessGrid grid(transport, shape.first, shape.second);
+          auto c = S21DistributedMatrix::Scatter(grid, a, 2);
+          c.MulMatrix(S21DistributedMatrix::Scatter(grid, b, 2));
+          S21Matrix product = c.Gather();
+          if (transport.Rank() == 0) {
+            EXPECT_TRUE(product == a * b);
+          }
+          auto other = S21DistributedMatrix::Scatter(grid, b, 3);
+          EXPECT_THROW(c.MulMatrix(other), std::logic_error);
+        });
+  }
+}
+
+TEST(distributed, lu_determinant_solve_and_inverse) {
+  S21Matrix a = S21Matrix::Random(10, 10, 43);
+  S21Matrix rhs = S21Matrix::Random(10, 3, 44);
+  const double determinant = S21LU(a).Determinant();
+  for (auto shape : {std::make_pair(2, 2), std::make_pair(3, 1),
+                     std::make_pair(1, 2)}) {
+    S21LocalTransport::Run(
+        shape.first * shape.second, [&](S21Transport& transport) {
+          S21ProcessGrid grid(transport, shape.first, shape.second);
+          auto d = S21DistributedMatrix::Scatter(grid, a, 3);
+          S21DistributedLU lu(d);
+          EXPECT_FALSE(lu.IsSingular());
+          S21Matrix factors = lu.GetFactors().Gather();
+          EXPECT_NEAR(d.Determinant(), determinant, 1e-9);
+          S21Matrix x =
+              lu.Solve(S21DistributedMatrix::Scatter(grid, rhs, 3)).Gather();
+          S21Matrix inverse = d.InverseMatrix().Gather();
+          if (transport.Rank() == 0) {
+            EXPECT_TRUE(factors == S21LU(a).GetFactors());
+            EXPECT_TRUE(a * x == rhs);
+            EXPECT_TRUE(inverse * a == S21Matrix::Identity(10));
+          }
+        });
+  }
+}
+
+TEST(distributed, singular_matrix) {
+  S21LocalTransport::Run(4, [](S21Transport& transport) {
+    S21ProcessGrid grid(transport);
+    auto d = S21DistributedMatrix::FromGenerator(
+        grid, 5, 5, 2, [](int i, int j) { return 3.0 * i + j + 1; });
+    EXPECT_TRUE(S21DistributedLU(d).IsSingular());
+    EXPECT_DOUBLE_EQ(d.Determinant(), 0);
+    EXPECT_THROW(d.InverseMatrix(), std::logic_error);
+    auto wide = S21DistributedMatrix(grid, 3, 4, 2);
+    EXPECT_THROW(S21DistributedLU{wide}, std::logic_error);
+  });
+}
+
+TEST(distributed, socket_ranks) {
+  S21Matrix a = S21Matrix::Random(8, 8, 45);
+  S21SocketTransport::Spawn(3, [&](S21Transport& transport) {
+    S21ProcessGrid grid(transport);
+    auto d = S21DistributedMatrix::Scatter(grid, a, 2);
+    double determinant = d.Determinant();
+    d.MulMatrix(d);
+    S21Matrix square = d.Gather();
+    // only rank 0 is this process
+    if (transport.Rank() == 0) {
+      EXPECT_EQ(grid.GetCols(), 3);
+      EXPECT_TRUE(square == a * a);
+      EXPECT_NEAR(determinant, a.Determinant(), 1e-9);
+    }
+  });
+  EXPECT_THROW(S21SocketTransport::Spawn(2,
+                                         [](S21Transport& transport) {
+                                           if (transport.Rank() == 1) {
+                                             throw std::runtime_error("");
+                                           }
+                                         }),
+               std::runtime_error);
+  EXPECT_THROW(S21SocketTransport::Spawn(2,
+                                         [](S21Transport& transport) {
+                                           if (transport.Rank() == 1) {
+                                             throw std::runtime_error("");
+                                           }
+                                           transport.Receive(1, 1);
+                                         }),
+               std::runtime_error);
+}
+
+static void writeText(const char* path, const char* text) {
+  std::ofstream(path, std::ios::binary) << text;
+}
+
+TEST(io, csv_round_trip_is_exact) {
+  // large enough for several chunks
+  S21Matrix a =
+      S21Matrix::Random(300, 200, 50, S21Matrix::Distribution::kNormal);
+  a(0, 0) = -0.0;
+  a(1, 1) = 1e-310;
+  a(2, 2) = 1e300;
+  a.ToCSV("test_io.csv");
+  S21Matrix b = S21Matrix::FromCSV("test_io.csv");
+  EXPECT_TRUE(a.EqMatrix(b, S21EqualityPolicy{0.0, 0.0, 0}));
+  a.Transpose().ToCSV("test_io.csv", ';');
+  EXPECT_TRUE(S21Matrix::FromCSV("test_io.csv", ';') == a.Transpose());
+  std::remove("test_io.csv");
+}
+
+TEST(io, csv_layout) {
+  writeText("test_io.csv", "1, 2 ,+3\r\n\n  -4.5,5e2,  6\r\n  \n");
+  S21Matrix a = S21Matrix::FromCSV("test_io.csv");
+  EXPECT_EQ(a.GetRows(), 2);
+  EXPECT_EQ(a.GetCols(), 3);
+  EXPECT_DOUBLE_EQ(a(0, 2), 3);
+  EXPECT_DOUBLE_EQ(a(1, 0), -4.5);
+  EXPECT_DOUBLE_EQ(a(1, 1), 500);
+  writeText("test_io.csv", "1\t2\n3\t4");
+  EXPECT_TRUE(S21Matrix::FromCSV("test_io.csv", '\t') ==
+              S21Matrix::FromGenerator(
+                  2, 2, [](int i, int j) { return 2.0 * i + j + 1; }));
+  writeText("test_io.csv", "");
+  EXPECT_EQ(S21Matrix::FromCSV("test_io.csv").GetRows(), 0);
+  for (const char* text : {"1,2\n3\n", "1,2\n3,4,5\n", "1,x\n", "1,,2\n",
+                           "1,2,\n", "1 2\n"}) {
+    writeText("test_io.csv", text);
+    EXPECT_THROW(S21Matrix::FromCSV("test_io.csv"), std::invalid_argument);
+  }
+  std::remove("test_io.csv");
+  EXPECT_THROW(S21Matrix::FromCSV("test_io.csv"), std::runtime_error);
+  EXPECT_THROW(S21Matrix(2, 2).ToCSV("no/such/directory.csv"),
+               std::runtime_error);
+}
+
+TEST(io, matrix_market_round_trip) {
+  S21Matrix a = S21Matrix::Random(250, 180, 51);
+  for (auto i = 0; i < 250; i++) {
+    for (auto j = 0; j < 180; j++) {
+      if ((i + 2 * j) % 3) a(i, j) = 0;
+    }
+  }
+  for (auto format :
+       {S21MatrixMarketFormat::kArray, S21MatrixMarketFormat::kCoordinate}) {
+    a.ToMatrixMarket("test_io.mtx", format);
+    EXPECT_TRUE(S21Matrix::FromMatrixMarket("test_io.mtx")
+                    .EqMatrix(a, S21EqualityPolicy{0.0, 0.0, 0}));
+  }
+  S21Matrix(0, 3).ToMatrixMarket("test_io.mtx",
+                                 S21MatrixMarketFormat::kCoordinate);
+  EXPECT_EQ(S21Matrix::FromMatrixMarket("test_io.mtx").GetCols(), 3);
+  std::remove("test_io.mtx");
+}
+
+TEST(io, matrix_market_variants) {
+  S21Matrix expected = S21Matrix::FromGenerator(
+      3, 3, [](int i, int j) { return 1.0 * std::min(i, j) + i + j; });
+  writeText("test_io.mtx",
+            "%%MatrixMarket matrix coordinate real symmetric\n"
+            "% comment\n\n3 3 5\n1 1 0\n2 1 1\n3 1 2\n2 2 3\n3 2 4\n"
+            "3 3 6\n");
+  EXPECT_THROW(S21Matrix::FromMatrixMarket("test_io.mtx"),
+               std::invalid_argument);
+  writeText("test_io.mtx",
+            "%%MatrixMarket matrix coordinate real symmetric\n"
+            "% comment\n\n3 3 5\n2 1 1\n3 1 2\n2 2 3\n3 2 4\n3 3 6\n");
+  EXPECT_TRUE(S21Matrix::FromMatrixMarket("test_io.mtx") == expected);
+  writeText("test_io.mtx",
+            "%%MatrixMarket matrix array integer symmetric\n"
+            "3 3\n0\n1\n2\n3\n4\n6\n");
+  EXPECT_TRUE(S21Matrix::FromMatrixMarket("test_io.mtx") == expected);
+  writeText("test_io.mtx",
+            "%%MatrixMarket matrix array real skew-symmetric\n3 3\n1\n2\n3\n");
+  EXPECT_TRUE(S21Matrix::FromMatrixMarket("test_io.mtx") ==
+              S21Matrix::FromGenerator(3, 3, [](int i, int j) {
+                return i > j ? i + j : j > i ? -1.0 * (i + j) : 0.0;
+              }));
+  writeText("test_io.mtx",
+            "%%MatrixMarket Matrix Coordinate Pattern General\n2 3 2\n"
+            "1 3\n2 1\n");
+  S21Matrix pattern = S21Matrix::FromMatrixMarket("test_io.mtx");
+  EXPECT_EQ(pattern.GetCols(), 3);
+  EXPECT_DOUBLE_EQ(pattern(0, 2), 1);
+  EXPECT_DOUBLE_EQ(pattern.Sum(), 2);
+  for (const char* text :
+       {"", "1 2\n1\n2\n",
+        "%%MatrixMarket matrix array complex general\n1 1\n1 0\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1\n",
+        "%%MatrixMarket matrix array real general\n2 1\n1\n2 3\n",
+        "%%MatrixMarket matrix array real symmetric\n2 3\n",
+        "%%MatrixMarket matrix array real general\n",
+        // sizes whose element counts overflow a long
+        "%%MatrixMarket matrix array real general\n9000000000 9000000000\n",
+        "%%MatrixMarket matrix array real symmetric\n"
+        "4000000000 4000000000\n"}) {
+    writeText("test_io.mtx", text);
+    EXPECT_THROW(S21Matrix::FromMatrixMarket("test_io.mtx"),
+                 std::invalid_argument);
+  }
+  std::remove("test_io.mtx");
+}
+
+TEST(lowrank, sketches) {
+  S21Matrix a = S21Matrix::Random(6, 16, 60);
+  S21Matrix b = S21Matrix::Random(16, 5, 61);
+  // all positions of a power of two size: Omega is orthogonal
+  S21Sketch full(16, 16, S21SketchKind::kSrht, 1);
+  EXPECT_TRUE(full.ApproximateProduct(a, b) == a * b);
+  EXPECT_NEAR(full.Apply(a).FrobeniusNorm(), a.FrobeniusNorm(), 1e-12);
+  for (auto kind : {S21SketchKind::kGaussian, S21SketchKind::kSrht}) {
+    S21Sketch sketch(16, 8, kind, 2);
+    EXPECT_EQ(sketch.Apply(a).GetCols(), 8);
+    EXPECT_TRUE(sketch.ApplyLeft(b) ==
+                sketch.Apply(b.Transpose()).Transpose());
+    EXPECT_THROW(sketch.Apply(b), std::logic_error);
+    // norms survive on average over many rows
+    S21Matrix rows = S21Matrix::Random(400, 16, 62,
+                                       S21Matrix::Distribution::kNormal);
+    EXPECT_NEAR(sketch.Apply(rows).FrobeniusNorm() / rows.FrobeniusNorm(), 1,
+                0.25);
+  }
+  EXPECT_THROW(S21Sketch(12, 17, S21SketchKind::kSrht, 0),
+               std::invalid_argument);
+  EXPECT_NO_THROW(S21Sketch(12, 16, S21SketchKind::kSrht, 0));
+  EXPECT_THROW(S21Sketch(12, 0, S21SketchKind::kGaussian, 0),
+               std::invalid_argument);
+}
+
+TEST(lowrank, range_finder) {
+  S21Matrix full = S21Matrix::Random(60, 40, 63);
+  S21Matrix q = full.RangeFinder(15);
+  EXPECT_EQ(q.GetRows(), 60);
+  EXPECT_EQ(q.GetCols(), 15);
+  EXPECT_TRUE(q.Transpose() * q == S21Matrix::Identity(15));
+  EXPECT_EQ(full.RangeFinder(100).GetCols(), 40);
+
+  // rank 6: the basis captures it exactly, extra columns come out zero
+  S21Matrix low =
+      S21Matrix::Random(80, 6, 64) * S21Matrix::Random(6, 50, 65);
+  S21RandomizedOptions options;
+  options.sketch = S21SketchKind::kSrht;
+  options.power_iterations = 0;
+  S21Matrix basis = low.RangeFinder(10, options);
+  EXPECT_TRUE(basis * (basis.Transpose() * low) == low);
+  EXPECT_NEAR((basis.Transpose() * basis).Trace(), 6, 1e-9);
+  options.power_iterations = -1;
+  EXPECT_THROW(low.RangeFinder(10, options), std::invalid_argument);
+  EXPECT_THROW(low.RangeFinder(0), std::invalid_argument);
+}
+
+TEST(lowrank, randomized_svd) {
+  // A = U * diag(2^-i) * V^T with known singular values
+  const int size = 30;
+  S21Matrix u = S21Matrix::Random(120, size, 66).RangeFinder(size);
+  S21Matrix v = S21Matrix::Random(90, size, 67).RangeFinder(size);
+  S21Matrix sigma = S21Matrix::FromGenerator(
+      size, size, [](int i, int j) { return i == j ? std::ldexp(1, -i) : 0; });
+  S21Matrix a = u * sigma * v.Transpose();
+  for (auto kind : {S21SketchKind::kGaussian, S21SketchKind::kSrht}) {
+    S21RandomizedOptions options;
+    options.sketch = kind;
+    options.seed = 7;
+    S21LowRankMatrix svd = S21LowRankMatrix::RandomizedSvd(a, 8, options);
+    EXPECT_EQ(svd.GetRank(), 8);
+    for (auto i = 0; i < 8; i++) {
+      EXPECT_NEAR(svd.GetSingularValues()[i], std::ldexp(1, -i), 1e-9);
+    }
+    EXPECT_TRUE(svd.GetU().Transpose() * svd.GetU() == S21Matrix::Identity(8));
+    EXPECT_TRUE(svd.GetV().Transpose() * svd.GetV() == S21Matrix::Identity(8));
+    // the error of the best rank 8 approximation
+    EXPECT_NEAR((a - svd.ToDense()).FrobeniusNorm(),
+                std::sqrt(4.0 / 3) * std::ldexp(1, -8), 1e-9);
+  }
+  EXPECT_THROW(S21LowRankMatrix::RandomizedSvd(a, 0), std::invalid_argument);
+}
+
+TEST(lowrank, factored_operations) {
+  S21Matrix left = S21Matrix::Random(40, 5, 68);
+  S21Matrix right = S21Matrix::Random(30, 5, 69);
+  S21Matrix dense = left * right.Transpose();
+  S21LowRankMatrix a(left, right);
+  EXPECT_EQ(a.GetRows(), 40);
+  EXPECT_EQ(a.GetCols(), 30);
+  EXPECT_TRUE(a.ToDense() == dense);
+  EXPECT_TRUE(a.Transpose().ToDense() == dense.Transpose());
+  EXPECT_NEAR(a.FrobeniusNorm(), dense.FrobeniusNorm(), 1e-9);
+  S21Matrix x = S21Matrix::Random(30, 3, 70);
+  EXPECT_TRUE(a.Multiply(x) == dense * x);
+  EXPECT_THROW(a.Multiply(S21Matrix(40, 1)), std::logic_error);
+
+  S21LowRankMatrix b(S21Matrix::Random(30, 4, 71),
+                     S21Matrix::Random(20, 4, 72));
+  S21LowRankMatrix product = a.Multiply(b);
+  EXPECT_EQ(product.GetRank(), 4);
+  EXPECT_TRUE(product.ToDense() == dense * b.ToDense());
+  EXPECT_THROW(b.Multiply(b), std::logic_error);
+
+  // b = A * x0 is consistent, the solution is the one in the row space
+  S21Matrix rhs = dense * x;
+  S21Matrix solution = a.Solve(rhs);
+  EXPECT_TRUE(dense * solution == rhs);
+  EXPECT_TRUE(a.GetV() * (a.GetV().Transpose() * solution) == solution);
+  EXPECT_THROW(a.Solve(x), std::logic_error);
+
+  a.Truncate(2);
+  EXPECT_EQ(a.GetRank(), 2);
+  EXPECT_EQ(a.GetU().GetCols(), 2);
+  EXPECT_THROW(a.Truncate(-1), std::invalid_argument);
+  EXPECT_THROW(S21LowRankMatrix(left, x), std::logic_error);
+}
+
 int main() {
   testing::InitGoogleTest();
   if (RUN_ALL_TESTS()) {